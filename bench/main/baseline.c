@@ -0,0 +1,170 @@
+#include "baseline.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cJSON.h"
+
+#define THRESHOLD_TEMP (1 * 0.1f)
+#define THRESHOLD_HUM (5 * 0.1f)
+#define SEND_INTERVAL_HEARTBEAT_US 60000000
+
+void baseline_convert_i1(uint8_t *dst, const uint8_t *px_map, int hor_res, int x1, int y1, int x2, int y2)
+{
+    for (int y = y1; y <= y2; y++)
+    {
+        for (int x = x1; x <= x2; x++)
+        {
+            bool chroma_color = (px_map[(hor_res >> 3) * y + (x >> 3)] & 1 << (7 - x % 8));
+            uint8_t *buf = dst + hor_res * (y >> 3) + (x);
+            if (chroma_color)
+            {
+                (*buf) &= ~(1 << (y % 8));
+            }
+            else
+            {
+                (*buf) |= (1 << (y % 8));
+            }
+        }
+    }
+}
+
+int baseline_format_values(char *buf, size_t size, float temperature, float humidity)
+{
+    int t_int = (int)temperature;
+    int t_dec = (int)((temperature - t_int) * 10);
+    if (t_dec < 0)
+        t_dec = -t_dec;
+
+    int h_int = (int)humidity;
+    int h_dec = (int)((humidity - h_int) * 10);
+    if (h_dec < 0)
+        h_dec = -h_dec;
+
+    return snprintf(buf, size, "%d.%d°C %d.%d%%", t_int, t_dec, h_int, h_dec);
+}
+
+size_t baseline_discovery(const char *device_id, const char *device_name, const char *topic_state,
+                          const char *topic_lwt)
+{
+    size_t total = 0;
+
+    // Temperature config
+    cJSON *root_t = cJSON_CreateObject();
+    cJSON_AddStringToObject(root_t, "name", "Room Temperature");
+    cJSON_AddStringToObject(root_t, "dev_cla", "temperature");
+    cJSON_AddStringToObject(root_t, "stat_cla", "measurement");
+    cJSON_AddStringToObject(root_t, "unit_of_meas", "°C");
+    cJSON_AddStringToObject(root_t, "stat_t", topic_state);
+    cJSON_AddStringToObject(root_t, "val_tpl", "{{ value_json.temperature }}");
+    cJSON_AddStringToObject(root_t, "uniq_id", "esp32-sensor-AABBCC-temp");
+
+    cJSON_AddStringToObject(root_t, "avty_t", topic_lwt);
+    cJSON_AddStringToObject(root_t, "pl_avail", "online");
+    cJSON_AddStringToObject(root_t, "pl_not_avail", "offline");
+
+    cJSON *dev = cJSON_CreateObject();
+    cJSON_AddStringToObject(dev, "ids", device_id);
+    cJSON_AddStringToObject(dev, "name", device_name);
+    cJSON_AddStringToObject(dev, "mf", "Espressif");
+    cJSON_AddItemToObject(root_t, "dev", dev);
+
+    char *json_str_t = cJSON_PrintUnformatted(root_t);
+    total += json_str_t ? strlen(json_str_t) : 0;
+    cJSON_Delete(root_t);
+    free(json_str_t);
+
+    // Humidity config
+    cJSON *root_h = cJSON_CreateObject();
+    cJSON_AddStringToObject(root_h, "name", "Room Humidity");
+    cJSON_AddStringToObject(root_h, "dev_cla", "humidity");
+    cJSON_AddStringToObject(root_h, "stat_cla", "measurement");
+    cJSON_AddStringToObject(root_h, "unit_of_meas", "%");
+    cJSON_AddStringToObject(root_h, "stat_t", topic_state);
+    cJSON_AddStringToObject(root_h, "val_tpl", "{{ value_json.humidity }}");
+    cJSON_AddStringToObject(root_h, "uniq_id", "esp32-sensor-AABBCC-hum");
+
+    cJSON_AddStringToObject(root_h, "avty_t", topic_lwt);
+    cJSON_AddStringToObject(root_h, "pl_avail", "online");
+    cJSON_AddStringToObject(root_h, "pl_not_avail", "offline");
+
+    cJSON *dev2 = cJSON_CreateObject();
+    cJSON_AddStringToObject(dev2, "ids", device_id);
+    cJSON_AddItemToObject(root_h, "dev", dev2);
+
+    char *json_str_h = cJSON_PrintUnformatted(root_h);
+    total += json_str_h ? strlen(json_str_h) : 0;
+    cJSON_Delete(root_h);
+    free(json_str_h);
+
+    return total;
+}
+
+int baseline_state_payload(char *buf, size_t size, float temp, float hum)
+{
+    return snprintf(buf, size, "{\"temperature\":%.1f,\"humidity\":%.1f}", temp, hum);
+}
+
+bool baseline_publish_due(float current_temp, float current_hum, float last_sent_temp, float last_sent_hum,
+                          int64_t now, int64_t last_send_time)
+{
+    bool diff_temp = fabs(current_temp - last_sent_temp) >= THRESHOLD_TEMP;
+    bool diff_hum = fabs(current_hum - last_sent_hum) >= THRESHOLD_HUM;
+    bool heartbeat = (now - last_send_time) > SEND_INTERVAL_HEARTBEAT_US;
+
+    return diff_temp || diff_hum || heartbeat;
+}
+
+int baseline_log_format(char *buf, size_t size, uint32_t timestamp, float temp, float hum)
+{
+    return snprintf(buf, size, "I (%lu) %s: Update sent. T:%.1f H:%.1f\n", (unsigned long)timestamp, "MAIN", temp, hum);
+}
+
+void baseline_comfort(float temp, float hum, float *dew_point, float *abs_humidity, float *heat_index)
+{
+    // Magnus coefficients over water
+    const float b = 17.62f, c = 243.12f;
+    float g = logf(fmaxf(hum, 0.1f) / 100.0f) + b * temp / (c + temp);
+    *dew_point = c * g / (b - g);
+
+    float es = 6.112f * expf(b * temp / (c + temp));
+    *abs_humidity = 216.7f * es / (273.15f + temp) * hum / 100.0f;
+
+    // NOAA heat index, computed in °F
+    float f = temp * 9.0f / 5.0f + 32.0f;
+    float hi = 0.5f * (f + 61.0f + (f - 68.0f) * 1.2f + hum * 0.094f);
+    if ((hi + f) / 2.0f >= 80.0f)
+    {
+        hi = -42.379f + 2.04901523f * f + 10.14333127f * hum - 0.22475541f * f * hum - 6.83783e-3f * f * f -
+             5.481717e-2f * hum * hum + 1.22874e-3f * f * f * hum + 8.5282e-4f * f * hum * hum -
+             1.99e-6f * f * f * hum * hum;
+        if (hum < 13.0f && f >= 80.0f && f <= 112.0f)
+            hi -= ((13.0f - hum) / 4.0f) * sqrtf((17.0f - fabsf(f - 95.0f)) / 17.0f);
+        else if (hum > 85.0f && f >= 80.0f && f <= 87.0f)
+            hi += ((hum - 85.0f) / 10.0f) * ((87.0f - f) / 5.0f);
+    }
+    *heat_index = temp < 20.0f ? temp : (hi - 32.0f) * 5.0f / 9.0f;
+}
+
+int baseline_history_chunk(const baseline_sample_t *samples, unsigned count, unsigned *pos, unsigned seq, char *buf,
+                           size_t size)
+{
+    int len = snprintf(buf, size, "{\"id\":\"%s\",\"seq\":%u,\"now\":%lu,\"samples\":[", "bench", seq, 0UL);
+    unsigned first = *pos;
+    while (*pos < count)
+    {
+        char item[48];
+        const baseline_sample_t *s = &samples[*pos];
+        int n = snprintf(item, sizeof(item), "%s[%lu,%.1f,%.1f]", *pos > first ? "," : "", (unsigned long)s->time_s,
+                         s->temp, s->hum);
+        if ((size_t)(len + n + 16) > size)
+            break;
+        memcpy(buf + len, item, n);
+        len += n;
+        (*pos)++;
+    }
+    len += snprintf(buf + len, size - len, "],\"last\":%s}", *pos >= count ? "true" : "false");
+    return len;
+}
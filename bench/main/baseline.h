@@ -0,0 +1,42 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Frozen copies of the data path as it was when the benchmarks were added.
+// Every benchmark runs against these as well, so each report carries its own
+// baseline from the same machine. Do not optimise this file.
+
+void baseline_convert_i1(uint8_t *dst, const uint8_t *px_map, int hor_res, int x1, int y1, int x2, int y2);
+
+int baseline_format_values(char *buf, size_t size, float temperature, float humidity);
+
+// Both discovery payloads built with cJSON, as mqtt_helper_send_discovery() used to
+size_t baseline_discovery(const char *device_id, const char *device_name, const char *topic_state,
+                          const char *topic_lwt);
+
+int baseline_state_payload(char *buf, size_t size, float temp, float hum);
+
+bool baseline_publish_due(float current_temp, float current_hum, float last_sent_temp, float last_sent_hum,
+                          int64_t now, int64_t last_send_time);
+
+// Formatting done by ESP_LOGI for the per-cycle "Update sent" line (without the UART write)
+int baseline_log_format(char *buf, size_t size, uint32_t timestamp, float temp, float hum);
+
+// Not a frozen copy: comfort metrics never shipped in float. This is the
+// straightforward libm port of the reference formulas the tables are built from.
+void baseline_comfort(float temp, float hum, float *dew_point, float *abs_humidity, float *heat_index);
+
+// Not a frozen copy: there was no history before. Uncompressed float samples
+// in a plain ring, formatted with %.1f, as a straightforward implementation would.
+typedef struct
+{
+    uint32_t time_s;
+    float temp;
+    float hum;
+} baseline_sample_t;
+
+// Builds one chunk in the history_chunk() layout from samples [*pos, count).
+// Advances *pos past the samples written. Returns the length.
+int baseline_history_chunk(const baseline_sample_t *samples, unsigned count, unsigned *pos, unsigned seq, char *buf,
+                           size_t size);
@@ -0,0 +1,99 @@
+#include "bench.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_WARMUP_SAMPLES 100
+#define BENCH_SAMPLES 2000
+
+volatile uint32_t bench_sink;
+
+static bool s_first = true;
+static double s_ns[BENCH_SAMPLES];
+static double s_cycles[BENCH_SAMPLES];
+
+static inline uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Time-stamp counter where available (constant rate, close to core cycles on modern x86)
+static inline uint64_t now_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, int n, double p)
+{
+    int idx = (int)(p * (n - 1) + 0.5);
+    return sorted[idx];
+}
+
+static void print_stats(const char *key, double *samples, int n)
+{
+    double sum = 0;
+    for (int i = 0; i < n; i++)
+        sum += samples[i];
+    qsort(samples, n, sizeof(samples[0]), cmp_double);
+
+    printf("\"%s\":{\"min\":%.2f,\"mean\":%.2f,\"p50\":%.2f,\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f}",
+           key, samples[0], sum / n, percentile(samples, n, 0.50), percentile(samples, n, 0.90),
+           percentile(samples, n, 0.99), samples[n - 1]);
+}
+
+void bench_begin(void)
+{
+    printf("{\"cycle_source\":\"%s\",\"samples\":%d,\"benchmarks\":[\n", now_cycles() ? "tsc" : "none", BENCH_SAMPLES);
+    s_first = true;
+}
+
+void bench_run(const char *name, const char *impl, bench_fn_t fn, void *ctx, int ops_per_sample)
+{
+    for (int i = 0; i < BENCH_WARMUP_SAMPLES * ops_per_sample; i++)
+        fn(ctx);
+
+    for (int s = 0; s < BENCH_SAMPLES; s++)
+    {
+        uint64_t c0 = now_cycles();
+        uint64_t t0 = now_ns();
+        for (int i = 0; i < ops_per_sample; i++)
+            fn(ctx);
+        uint64_t t1 = now_ns();
+        uint64_t c1 = now_cycles();
+
+        s_ns[s] = (double)(t1 - t0) / ops_per_sample;
+        s_cycles[s] = (double)(c1 - c0) / ops_per_sample;
+    }
+
+    printf("%s  {\"name\":\"%s\",\"impl\":\"%s\",\"ops_per_sample\":%d,", s_first ? "" : ",\n", name, impl,
+           ops_per_sample);
+    print_stats("ns", s_ns, BENCH_SAMPLES);
+    if (now_cycles())
+    {
+        printf(",");
+        print_stats("cycles", s_cycles, BENCH_SAMPLES);
+    }
+    printf("}");
+    fflush(stdout);
+    s_first = false;
+}
+
+void bench_end(void)
+{
+    printf("\n]}\n");
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+// Minimal benchmark harness: per-op nanoseconds (and TSC cycles on x86) with
+// percentiles, printed as one JSON document on stdout.
+
+typedef void (*bench_fn_t)(void *ctx);
+
+// Defeats dead-code elimination: benchmarked functions store a result here
+extern volatile uint32_t bench_sink;
+
+void bench_begin(void);
+
+// Runs fn ops_per_sample times per sample and reports the per-op distribution.
+// impl is "current" or "baseline".
+void bench_run(const char *name, const char *impl, bench_fn_t fn, void *ctx, int ops_per_sample);
+
+void bench_end(void);
@@ -0,0 +1,338 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "baseline.h"
+#include "bench.h"
+#include "comfort.h"
+#include "gui_render.h"
+#include "history.h"
+#include "mqtt_payload.h"
+#include "publish_policy.h"
+#include "test.h"
+#include "tlog.h"
+
+#define LCD_H_RES 128
+#define LCD_V_RES 32
+
+static const char *DEVICE_ID = "esp32-sensor-AABBCC";
+static const char *DEVICE_NAME = "ESP32 Sensor AABBCC";
+static const char *TOPIC_STATE = "homeassistant/sensor/esp32-sensor-AABBCC/state";
+static const char *TOPIC_LWT = "homeassistant/sensor/esp32-sensor-AABBCC/availability";
+
+// Inputs cycle through a small table so nothing is constant-folded
+#define N_VALUES 64
+static float s_temps[N_VALUES];
+static float s_hums[N_VALUES];
+static unsigned s_idx = 0;
+
+static uint8_t s_px_map[LCD_H_RES * LCD_V_RES / 8];
+static uint8_t s_oled[LCD_H_RES * LCD_V_RES / 8];
+static char s_buf[512];
+
+// One day of readings at the default interval, retrieved in 512-byte chunks
+#define HISTORY_SPAN_S (24 * 3600)
+#define HISTORY_INTERVAL_S 60
+#define HISTORY_SAMPLES (HISTORY_SPAN_S / HISTORY_INTERVAL_S)
+#define HISTORY_CHUNK_SIZE 512
+static history_block_t s_hist_blocks[HISTORY_BLOCKS_FOR(HISTORY_SPAN_S, HISTORY_INTERVAL_S)];
+static history_t s_hist;
+static baseline_sample_t s_hist_plain[HISTORY_SAMPLES];
+static uint32_t s_hist_time = 0;
+
+// Value line glyphs shaped like the generated Montserrat 14 atlas: two pages,
+// about 8 columns each. The bitmaps are filled in init_inputs().
+#define VALUE_PAGE 2
+#define VALUE_PAGES 2
+static const gui_atlas_glyph_t s_atlas_glyphs[] = {
+    {' ', 0, 0, 4},    {'%', 0, 11, 12},  {'-', 22, 5, 6},   {'.', 32, 3, 4},   {'0', 38, 8, 9},
+    {'1', 54, 4, 5},   {'2', 62, 8, 9},   {'3', 78, 8, 9},   {'4', 94, 9, 9},   {'5', 112, 8, 9},
+    {'6', 128, 8, 9},  {'7', 144, 8, 9},  {'8', 160, 8, 9},  {'9', 176, 8, 9},  {'C', 192, 9, 10},
+    {0xB0, 210, 5, 6}, // °
+};
+static uint8_t s_atlas_bitmap[220];
+static const gui_atlas_t s_atlas = {
+    .glyphs = s_atlas_glyphs,
+    .count = sizeof(s_atlas_glyphs) / sizeof(s_atlas_glyphs[0]),
+    .pages = VALUE_PAGES,
+    .bitmap = s_atlas_bitmap,
+};
+
+static const publish_policy_t s_policy = {
+    .threshold_temp = 0.1f,
+    .threshold_hum = 0.5f,
+    .heartbeat_us = 60000000,
+};
+
+// ---------------- CASES ----------------
+
+static void flush_current(void *ctx)
+{
+    gui_render_convert_i1(s_oled, s_px_map, LCD_H_RES, 0, 0, LCD_H_RES - 1, LCD_V_RES - 1);
+    bench_sink = s_oled[s_idx++ % sizeof(s_oled)];
+}
+
+static void flush_baseline(void *ctx)
+{
+    baseline_convert_i1(s_oled, s_px_map, LCD_H_RES, 0, 0, LCD_H_RES - 1, LCD_V_RES - 1);
+    bench_sink = s_oled[s_idx++ % sizeof(s_oled)];
+}
+
+static void format_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    bench_sink = gui_render_format_values(s_buf, sizeof(s_buf), s_temps[i], s_hums[i]);
+}
+
+static void format_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    bench_sink = baseline_format_values(s_buf, sizeof(s_buf), s_temps[i], s_hums[i]);
+}
+
+// Same steps as draw_value_line() in gui.c, without the panel transfer
+static void value_line_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    char text[32];
+    gui_render_format_values(text, sizeof(text), s_temps[i], s_hums[i]);
+
+    uint8_t *pages = s_oled + VALUE_PAGE * LCD_H_RES;
+    memset(pages, 0, VALUE_PAGES * LCD_H_RES);
+    int x = (LCD_H_RES - gui_render_atlas_width(&s_atlas, text)) / 2;
+    gui_render_atlas_text(pages, LCD_H_RES, &s_atlas, x, text);
+    bench_sink = pages[LCD_H_RES / 2];
+}
+
+// The LVGL label path: format, then convert the label rows in the flush callback.
+// LVGL's own text rasterisation does not run on the host, so this is a lower bound.
+static void value_line_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    char text[32];
+    baseline_format_values(text, sizeof(text), s_temps[i], s_hums[i]);
+
+    baseline_convert_i1(s_oled, s_px_map, LCD_H_RES, 0, VALUE_PAGE * 8, LCD_H_RES - 1,
+                        (VALUE_PAGE + VALUE_PAGES) * 8 - 1);
+    bench_sink = s_oled[VALUE_PAGE * LCD_H_RES + LCD_H_RES / 2] + text[0];
+}
+
+static void state_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    bench_sink = mqtt_payload_state(s_buf, sizeof(s_buf), s_temps[i], s_hums[i], NULL);
+}
+
+static void state_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    bench_sink = baseline_state_payload(s_buf, sizeof(s_buf), s_temps[i], s_hums[i]);
+}
+
+static void discovery_current(void *ctx)
+{
+    const mqtt_discovery_t temp = {
+        .name = "Room Temperature",
+        .dev_cla = "temperature",
+        .unit = "°C",
+        .val_tpl = "{{ value_json.temperature }}",
+        .uniq_id = "esp32-sensor-AABBCC-temp",
+        .stat_t = TOPIC_STATE,
+        .avty_t = TOPIC_LWT,
+        .dev_ids = DEVICE_ID,
+        .dev_name = DEVICE_NAME,
+    };
+    const mqtt_discovery_t hum = {
+        .name = "Room Humidity",
+        .dev_cla = "humidity",
+        .unit = "%",
+        .val_tpl = "{{ value_json.humidity }}",
+        .uniq_id = "esp32-sensor-AABBCC-hum",
+        .stat_t = TOPIC_STATE,
+        .avty_t = TOPIC_LWT,
+        .dev_ids = DEVICE_ID,
+    };
+    int len = mqtt_payload_discovery(s_buf, sizeof(s_buf), &temp);
+    len += mqtt_payload_discovery(s_buf, sizeof(s_buf), &hum);
+    bench_sink = len;
+}
+
+static void discovery_baseline(void *ctx)
+{
+    bench_sink = baseline_discovery(DEVICE_ID, DEVICE_NAME, TOPIC_STATE, TOPIC_LWT);
+}
+
+static void comfort_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    comfort_t out;
+    comfort_compute(lroundf(s_temps[i] * 10.0f), lroundf(s_hums[i] * 10.0f), &out);
+    bench_sink = out.dew_point_c10 + out.abs_humidity_g100 + out.heat_index_c10;
+}
+
+static void comfort_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    float dew, ah, hi;
+    baseline_comfort(s_temps[i], s_hums[i], &dew, &ah, &hi);
+    bench_sink = (uint32_t)(int32_t)(dew + ah + hi);
+}
+
+// Stands in for the ring buffer of main/tlog.c: one copy per record
+static uint8_t s_ring[TLOG_MAX_RECORD];
+static size_t s_ring_len;
+
+void tlog_commit(const tlog_rec_t *rec)
+{
+    memcpy(s_ring, rec->buf, rec->len);
+    s_ring_len = rec->len;
+}
+
+static void log_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    // What a TLOGI call site pays, including both level checks
+    TLOG_LEVEL(ESP_LOG_INFO, "MAIN", "Update sent. T:%.1f H:%.1f", s_temps[i], s_hums[i]);
+    bench_sink = s_ring_len;
+}
+
+static void log_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    // ESP_LOGI looks up the tag level as well (in esp_log_write)
+    if (esp_log_level_get("MAIN") >= ESP_LOG_INFO)
+        bench_sink = baseline_log_format(s_buf, sizeof(s_buf), i, s_temps[i], s_hums[i]);
+}
+
+static void decision_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    publish_record_t last = {.temp = s_temps[(i + 1) % N_VALUES], .hum = s_hums[(i + 1) % N_VALUES], .time_us = i};
+    bench_sink = publish_policy_due(&s_policy, &last, s_temps[i], s_hums[i], (int64_t)i * 1000000);
+}
+
+static void decision_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    bench_sink = baseline_publish_due(s_temps[i], s_hums[i], s_temps[(i + 1) % N_VALUES], s_hums[(i + 1) % N_VALUES],
+                                      (int64_t)i * 1000000, i);
+}
+
+static void history_add_current(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    s_hist_time += HISTORY_INTERVAL_S;
+    history_add(&s_hist, s_hist_time, lroundf(s_temps[i] * 10.0f), lroundf(s_hums[i] * 10.0f));
+    bench_sink = s_hist.newest;
+}
+
+static void history_add_baseline(void *ctx)
+{
+    unsigned i = s_idx++ % N_VALUES;
+    s_hist_time += HISTORY_INTERVAL_S;
+    baseline_sample_t *slot = &s_hist_plain[(s_hist_time / HISTORY_INTERVAL_S) % HISTORY_SAMPLES];
+    *slot = (baseline_sample_t){.time_s = s_hist_time, .temp = s_temps[i], .hum = s_hums[i]};
+    bench_sink = slot->time_s;
+}
+
+// One op is the retrieval of the whole day, chunk by chunk
+static void history_stream_current(void *ctx)
+{
+    history_cursor_t cursor;
+    history_seek(&s_hist, &cursor, 0);
+    unsigned seq = 0, bytes = 0;
+    bool last = false;
+    while (!last)
+        bytes += history_chunk(&s_hist, &cursor, UINT32_MAX, "bench", seq++, 0, s_buf, HISTORY_CHUNK_SIZE, &last);
+    bench_sink = bytes;
+}
+
+static void history_stream_baseline(void *ctx)
+{
+    unsigned pos = 0, seq = 0, bytes = 0;
+    while (pos < HISTORY_SAMPLES)
+        bytes += baseline_history_chunk(s_hist_plain, HISTORY_SAMPLES, &pos, seq++, s_buf, HISTORY_CHUNK_SIZE);
+    bench_sink = bytes;
+}
+
+// ---------------- MAIN ----------------
+
+static void init_inputs(void)
+{
+    srand(42);
+    for (int i = 0; i < N_VALUES; i++)
+    {
+        // DHT22 range with 0.1 resolution
+        s_temps[i] = (rand() % 1200 - 400) / 10.0f;
+        s_hums[i] = (rand() % 1000) / 10.0f;
+    }
+    // A day of slowly drifting readings, like a room sensor
+    history_init(&s_hist, s_hist_blocks, sizeof(s_hist_blocks) / sizeof(s_hist_blocks[0]), HISTORY_INTERVAL_S);
+    int temp = 215, hum = 450;
+    for (int i = 0; i < HISTORY_SAMPLES; i++)
+    {
+        temp += rand() % 3 - 1;
+        hum += rand() % 5 - 2;
+        s_hist_time = (uint32_t)i * HISTORY_INTERVAL_S;
+        history_add(&s_hist, s_hist_time, temp, hum);
+        s_hist_plain[i] = (baseline_sample_t){.time_s = s_hist_time, .temp = temp / 10.0f, .hum = hum / 10.0f};
+    }
+
+    // Mostly sparse, text-like frame
+    for (size_t i = 0; i < sizeof(s_px_map); i++)
+        s_px_map[i] = (rand() % 4 == 0) ? (uint8_t)rand() : 0;
+    for (size_t i = 0; i < sizeof(s_atlas_bitmap); i++)
+        s_atlas_bitmap[i] = (uint8_t)rand();
+}
+
+int test_failures = 0;
+
+static void run_tests(void)
+{
+    test_cmd_json();
+    test_comfort();
+    test_device_state();
+    test_gesture();
+    test_gui_render();
+    test_history();
+    test_mqtt_payload();
+
+    if (test_failures)
+    {
+        fprintf(stderr, "%d check(s) failed\n", test_failures);
+        exit(1);
+    }
+}
+
+void app_main(void)
+{
+    run_tests();
+    init_inputs();
+
+    bench_begin();
+    bench_run("lvgl_flush_convert", "current", flush_current, NULL, 10);
+    bench_run("lvgl_flush_convert", "baseline", flush_baseline, NULL, 10);
+    bench_run("gui_format_values", "current", format_current, NULL, 100);
+    bench_run("gui_format_values", "baseline", format_baseline, NULL, 100);
+    bench_run("gui_value_line", "current", value_line_current, NULL, 100);
+    bench_run("gui_value_line", "baseline", value_line_baseline, NULL, 100);
+    bench_run("mqtt_state_payload", "current", state_current, NULL, 100);
+    bench_run("mqtt_state_payload", "baseline", state_baseline, NULL, 100);
+    bench_run("mqtt_discovery_payload", "current", discovery_current, NULL, 10);
+    bench_run("mqtt_discovery_payload", "baseline", discovery_baseline, NULL, 10);
+    bench_run("comfort_metrics", "current", comfort_current, NULL, 100);
+    bench_run("comfort_metrics", "baseline", comfort_baseline, NULL, 100);
+    bench_run("log_call", "current", log_current, NULL, 100);
+    bench_run("log_call", "baseline", log_baseline, NULL, 100);
+    bench_run("history_stream", "current", history_stream_current, NULL, 1);
+    bench_run("history_stream", "baseline", history_stream_baseline, NULL, 1);
+    bench_run("history_add", "current", history_add_current, NULL, 100);
+    bench_run("history_add", "baseline", history_add_baseline, NULL, 100);
+    bench_run("publish_decision", "current", decision_current, NULL, 1000);
+    bench_run("publish_decision", "baseline", decision_baseline, NULL, 1000);
+    bench_end();
+
+    // The linux target keeps the scheduler running otherwise
+    exit(0);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdio.h>
+
+// Correctness checks that run before the benchmarks. Failures are reported on
+// stderr and make bench.elf exit with status 1, so the JSON on stdout is only
+// produced for code that behaves as specified.
+
+extern int test_failures;
+
+#define TEST_CHECK(cond, ...)                                                     \
+    do                                                                            \
+    {                                                                             \
+        if (!(cond))                                                              \
+        {                                                                         \
+            test_failures++;                                                      \
+            fprintf(stderr, "FAIL %s:%d: ", __FILE__, __LINE__);                  \
+            fprintf(stderr, __VA_ARGS__);                                         \
+            fputc('\n', stderr);                                                  \
+        }                                                                         \
+    } while (0)
+
+void test_cmd_json(void);
+void test_comfort(void);
+void test_device_state(void);
+void test_gesture(void);
+void test_gui_render(void);
+void test_history(void);
+void test_mqtt_payload(void);
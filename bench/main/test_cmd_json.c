@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "cmd_json.h"
+#include "test.h"
+
+// cmd_json.c reads untrusted payloads from the OTA and history command topics
+
+#define LEN(s) (sizeof(s) - 1)
+
+static void check_string(const char *json, size_t len, const char *key, size_t size, bool ok, const char *expected)
+{
+    char out[64];
+    memset(out, 'x', sizeof(out));
+    bool found = cmd_json_string(json, len, key, out, size);
+    TEST_CHECK(found == ok && strcmp(out, expected) == 0, "cmd_json string %s in %.*s: %d \"%s\"", key, (int)len,
+               json, found, out);
+}
+
+static void check_uint(const char *json, size_t len, const char *key, bool ok, uint32_t expected)
+{
+    uint32_t out = 12345;
+    bool found = cmd_json_uint(json, len, key, &out);
+    TEST_CHECK(found == ok && (!ok || out == expected), "cmd_json uint %s in %.*s: %d %u", key, (int)len, json, found,
+               (unsigned)out);
+}
+
+void test_cmd_json(void)
+{
+    // Plain members, whitespace, escapes
+    static const char ota[] = "{ \"url\" : \"http://h/fw.bin\", \"delta\" : true }";
+    check_string(ota, LEN(ota), "url", 64, true, "http://h/fw.bin");
+    TEST_CHECK(cmd_json_true(ota, LEN(ota), "delta"), "cmd_json true: delta");
+
+    static const char esc[] = "{\"id\":\"a\\\"b\\\\c\\/d\"}";
+    check_string(esc, LEN(esc), "id", 64, true, "a\"b\\c/d");
+    static const char esc_other[] = "{\"id\":\"a\\n\"}"; // other escapes are not supported
+    check_string(esc_other, LEN(esc_other), "id", 64, false, "");
+    // An escaped quote inside another member's value does not end it
+    static const char esc_skip[] = "{\"x\":\"\\\",\\\"id\\\":\\\"no\",\"id\":\"yes\"}";
+    check_string(esc_skip, LEN(esc_skip), "id", 64, true, "yes");
+
+    // Strings that do not fit: exactly fitting works, one more fails with an empty result
+    static const char fit[] = "{\"id\":\"abcd\"}";
+    check_string(fit, LEN(fit), "id", 5, true, "abcd");
+    check_string(fit, LEN(fit), "id", 4, false, "");
+    check_string(fit, LEN(fit), "id", 1, false, "");
+
+    // Nested values are skipped, including brackets inside their strings
+    static const char nested[] = "{\"a\":{\"id\":\"inner\",\"b\":[1,{\"c\":\"}]\"}]},\"l\":[\"{\"],\"id\":\"outer\"}";
+    check_string(nested, LEN(nested), "id", 64, true, "outer");
+    check_uint(nested, LEN(nested), "c", false, 0);
+
+    // Integers: saturation, fraction ignored, wrong types
+    static const char nums[] = "{\"from\":3600,\"to\":99999999999,\"f\":1.5,\"neg\":-1,\"s\":\"7\"}";
+    check_uint(nums, LEN(nums), "from", true, 3600);
+    check_uint(nums, LEN(nums), "to", true, UINT32_MAX);
+    check_uint(nums, LEN(nums), "f", true, 1);
+    check_uint(nums, LEN(nums), "neg", false, 0);
+    check_uint(nums, LEN(nums), "s", false, 0);
+
+    // Only the exact literal true counts
+    static const char lits[] = "{\"a\":trueX,\"b\":\"true\",\"c\":false,\"d\":true}";
+    TEST_CHECK(!cmd_json_true(lits, LEN(lits), "a"), "cmd_json true: trueX");
+    TEST_CHECK(!cmd_json_true(lits, LEN(lits), "b"), "cmd_json true: string");
+    TEST_CHECK(!cmd_json_true(lits, LEN(lits), "c"), "cmd_json true: false");
+    TEST_CHECK(cmd_json_true(lits, LEN(lits), "d"), "cmd_json true: last member");
+
+    // Missing keys and keys that are only a prefix or suffix
+    check_string(ota, LEN(ota), "ur", 64, false, "");
+    check_string(ota, LEN(ota), "urls", 64, false, "");
+    check_uint(ota, LEN(ota), "from", false, 0);
+    TEST_CHECK(!cmd_json_true(ota, LEN(ota), "missing"), "cmd_json true: missing key");
+
+    // Input that stops mid-member: every prefix of a valid object fails safely.
+    // Each prefix gets its own allocation, so a sanitizer build catches reads past len.
+    static const char full[] = "{\"id\":\"abc\",\"from\":12,\"delta\":true}";
+    for (size_t n = 0; n < LEN(full); n++)
+    {
+        char *prefix = malloc(n ? n : 1);
+        memcpy(prefix, full, n);
+        char out[16];
+        uint32_t v;
+        bool id = cmd_json_string(prefix, n, "id", out, sizeof(out));
+        bool from = cmd_json_uint(prefix, n, "from", &v);
+        bool delta = cmd_json_true(prefix, n, "delta");
+        free(prefix);
+        // Members fully inside the prefix may be found, nothing beyond it
+        TEST_CHECK(!id || (n >= 11 && strcmp(out, "abc") == 0), "cmd_json prefix %zu: id", n);
+        TEST_CHECK(!from || (n >= 19 && v <= 12), "cmd_json prefix %zu: from", n);
+        TEST_CHECK(!delta || n >= 33, "cmd_json prefix %zu: delta", n);
+    }
+
+    // Not an object, empty input
+    check_string("[\"id\",\"x\"]", 10, "id", 64, false, "");
+    check_string("", 0, "id", 64, false, "");
+}
@@ -0,0 +1,104 @@
+#include <math.h>
+#include <stdbool.h>
+
+#include "comfort.h"
+#include "test.h"
+
+// Checks comfort.c over the whole sensor range (-40..80 °C, 1..100 % in 0.1
+// steps) against the double-precision formulas of tools/gen_comfort_lut.py.
+// The limits are the ones comfort_lut.h states, plus half a unit of the
+// third decimal they are printed with.
+
+#define MAX_ERR_DEW_POINT (0.064 + 0.0005)
+#define MAX_ERR_ABS_HUMIDITY (0.048 + 0.0005)
+#define MAX_ERR_HEAT_INDEX (0.965 + 0.0005)
+
+#define MAGNUS_B 17.62
+#define MAGNUS_C 243.12
+
+static double ref_dew_point(double t, double rh)
+{
+    double g = log(rh / 100.0) + MAGNUS_B * t / (MAGNUS_C + t);
+    return MAGNUS_C * g / (MAGNUS_B - g);
+}
+
+static double ref_abs_humidity(double t, double rh)
+{
+    double es = 6.112 * exp(MAGNUS_B * t / (MAGNUS_C + t));
+    return 216.7 * es / (273.15 + t) * rh / 100.0;
+}
+
+// NOAA/NWS: simple formula, Rothfusz regression with adjustments above 80 °F
+static double ref_heat_index(double t, double rh)
+{
+    double f = t * 9 / 5 + 32;
+    double hi = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094);
+    if ((hi + f) / 2 >= 80)
+    {
+        hi = -42.379 + 2.04901523 * f + 10.14333127 * rh - 0.22475541 * f * rh - 6.83783e-3 * f * f -
+             5.481717e-2 * rh * rh + 1.22874e-3 * f * f * rh + 8.5282e-4 * f * rh * rh - 1.99e-6 * f * f * rh * rh;
+        if (rh < 13 && f >= 80 && f <= 112)
+            hi -= ((13 - rh) / 4) * sqrt((17 - fabs(f - 95)) / 17);
+        else if (rh > 85 && f >= 80 && f <= 87)
+            hi += ((rh - 85) / 10) * ((87 - f) / 5);
+    }
+    return (hi - 32) * 5 / 9;
+}
+
+void test_comfort(void)
+{
+    double err_dp = 0, err_ah = 0, err_hi = 0;
+    int worst_dp[2] = {0}, worst_ah[2] = {0}, worst_hi[2] = {0};
+    bool hi_range_ok = true;
+
+    for (int t10 = -400; t10 <= 800; t10++)
+    {
+        for (int h10 = 10; h10 <= 1000; h10++)
+        {
+            double t = t10 / 10.0, rh = h10 / 10.0;
+            comfort_t c;
+            comfort_compute(t10, h10, &c);
+
+            double e = fabs(c.dew_point_c10 / 10.0 - ref_dew_point(t, rh));
+            if (e > err_dp)
+            {
+                err_dp = e;
+                worst_dp[0] = t10, worst_dp[1] = h10;
+            }
+            e = fabs(c.abs_humidity_g100 / 100.0 - ref_abs_humidity(t, rh));
+            if (e > err_ah)
+            {
+                err_ah = e;
+                worst_ah[0] = t10, worst_ah[1] = h10;
+            }
+
+            bool in_range = t10 >= 200 && t10 <= 500;
+            if (in_range != (c.heat_index_c10 != COMFORT_HI_NONE))
+                hi_range_ok = false;
+            if (!in_range || c.heat_index_c10 == COMFORT_HI_NONE)
+                continue;
+            e = fabs(c.heat_index_c10 / 10.0 - ref_heat_index(t, rh));
+            if (e > err_hi)
+            {
+                err_hi = e;
+                worst_hi[0] = t10, worst_hi[1] = h10;
+            }
+        }
+    }
+
+    TEST_CHECK(err_dp <= MAX_ERR_DEW_POINT, "comfort dew point: error %.3f °C at %d, %d", err_dp, worst_dp[0],
+               worst_dp[1]);
+    TEST_CHECK(err_ah <= MAX_ERR_ABS_HUMIDITY, "comfort abs humidity: error %.3f g/m³ at %d, %d", err_ah,
+               worst_ah[0], worst_ah[1]);
+    TEST_CHECK(err_hi <= MAX_ERR_HEAT_INDEX, "comfort heat index: error %.3f °C at %d, %d", err_hi, worst_hi[0],
+               worst_hi[1]);
+    TEST_CHECK(hi_range_ok, "comfort heat index: reported outside 20..50 °C or missing inside");
+
+    // The edges of the heat index range, at 0 % where the old clamp went wrong
+    TEST_CHECK(comfort_heat_index(199, 0) == COMFORT_HI_NONE, "comfort heat index at 19.9 °C: %d",
+               comfort_heat_index(199, 0));
+    TEST_CHECK(comfort_heat_index(501, 0) == COMFORT_HI_NONE, "comfort heat index at 50.1 °C: %d",
+               comfort_heat_index(501, 0));
+    TEST_CHECK(comfort_heat_index(200, 0) == (int)lround(ref_heat_index(20.0, 0) * 10),
+               "comfort heat index at 20.0 °C, 0 %%: %d", comfort_heat_index(200, 0));
+}
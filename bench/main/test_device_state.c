@@ -0,0 +1,144 @@
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "device_state.h"
+#include "test.h"
+
+// Seqlock stress test: writers and readers on separate pthreads, so they run
+// truly in parallel on a multi-core host (FreeRTOS tasks on the linux target
+// share one simulated core). Every sample a writer stores is self-consistent
+// (temperature = k, humidity = -k, time = k), so a torn snapshot shows up as a
+// mismatch. A snapshot that goes back in version, or in k for one writer, is
+// out of order.
+
+#define WRITERS 2
+#define READERS 3
+#define DURATION_MS 500
+
+typedef struct
+{
+    int index;
+    unsigned snapshots;
+    unsigned torn;
+    unsigned out_of_order;
+} reader_t;
+
+static atomic_bool s_done;
+static atomic_uint s_writes;
+
+static int64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void *writer_thread(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    int64_t end_ms = now_ms() + DURATION_MS;
+    unsigned writes = 0;
+
+    // k stays exact as float below 2^24; the writer is k % WRITERS
+    for (int32_t i = 0; i * WRITERS < (1 << 24); i++)
+    {
+        int32_t k = i * WRITERS + index;
+        device_state_set_sample((float)k, (float)-k, k);
+        writes++;
+        if (i % 64 == 0)
+        {
+            device_state_set_wifi_connected(i & 64); // a write that leaves the sample alone
+            writes++;
+            if (now_ms() >= end_ms)
+                break;
+        }
+    }
+    atomic_fetch_add(&s_writes, writes);
+    return NULL;
+}
+
+static void *reader_thread(void *arg)
+{
+    reader_t *r = arg;
+    uint32_t last_version = 0;
+    int64_t last_k[WRITERS];
+    for (int w = 0; w < WRITERS; w++)
+        last_k[w] = -1;
+
+    while (!atomic_load(&s_done))
+    {
+        device_state_t s;
+        uint32_t before = device_state_version();
+        device_state_get(&s);
+        uint32_t after = device_state_version();
+        r->snapshots++;
+
+        if (s.version < before || s.version > after || s.version < last_version)
+            r->out_of_order++;
+        last_version = s.version;
+
+        if (!s.sample_valid)
+            continue;
+        int64_t k = s.sample_time_us;
+        if (k < 0 || s.temperature != (float)k || s.humidity != (float)-k)
+        {
+            r->torn++;
+            continue;
+        }
+        if (k < last_k[k % WRITERS])
+            r->out_of_order++;
+        last_k[k % WRITERS] = k;
+    }
+    return NULL;
+}
+
+void test_device_state(void)
+{
+    pthread_t writers[WRITERS];
+    pthread_t readers[READERS];
+    reader_t results[READERS] = {0};
+
+    // Keep the FreeRTOS POSIX port's tick and yield signals on the task threads
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+
+    atomic_store(&s_done, false);
+    atomic_store(&s_writes, 0);
+    for (int i = 0; i < READERS; i++)
+    {
+        results[i].index = i;
+        pthread_create(&readers[i], NULL, reader_thread, &results[i]);
+    }
+    for (int i = 0; i < WRITERS; i++)
+        pthread_create(&writers[i], NULL, writer_thread, (void *)(intptr_t)i);
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    for (int i = 0; i < WRITERS; i++)
+        pthread_join(writers[i], NULL);
+    atomic_store(&s_done, true);
+    for (int i = 0; i < READERS; i++)
+        pthread_join(readers[i], NULL);
+
+    for (int i = 0; i < READERS; i++)
+    {
+        TEST_CHECK(results[i].snapshots > 0, "device_state reader %d: no snapshot", i);
+        TEST_CHECK(results[i].torn == 0, "device_state reader %d: %u torn of %u snapshots", i, results[i].torn,
+                   results[i].snapshots);
+        TEST_CHECK(results[i].out_of_order == 0, "device_state reader %d: %u out of order of %u snapshots", i,
+                   results[i].out_of_order, results[i].snapshots);
+    }
+
+    // Every write is counted exactly once
+    uint32_t expected = atomic_load(&s_writes);
+    device_state_t s;
+    device_state_get(&s);
+    TEST_CHECK(s.version == expected && device_state_version() == expected,
+               "device_state: version %u (sequence %u), expected %u", (unsigned)s.version,
+               (unsigned)device_state_version(), (unsigned)expected);
+}
@@ -0,0 +1,144 @@
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "gesture.h"
+#include "test.h"
+
+// Drives gesture.c the way main/input.c does: every raw edge restarts a
+// one-shot debounce timer, and when the timer expires the level is sampled,
+// gesture_update runs and its timeout re-arms the timer. Time advances in 1 ms
+// steps; an expiry is handled before an edge in the same step.
+
+#define DEBOUNCE_MS 30
+#define MAX_EVENTS 8
+
+static const gesture_config_t s_cfg = {
+    .long_press_ms = 1000,
+    .hold_ms = 3000,
+    .double_click_ms = 300,
+};
+
+typedef struct
+{
+    uint32_t at_ms;
+    bool pressed; // raw level from this time on
+} edge_t;
+
+typedef struct
+{
+    gesture_t gesture;
+    uint32_t at_ms;
+} event_t;
+
+typedef struct
+{
+    const char *name;
+    const gesture_config_t *cfg;
+    edge_t edges[16];
+    int edge_count;
+    uint32_t end_ms;
+    event_t expected[MAX_EVENTS];
+    int expected_count;
+} scenario_t;
+
+static int simulate(const scenario_t *sc, event_t *events)
+{
+    gesture_state_t state = {0};
+    bool level = false;
+    bool armed = false;
+    uint32_t deadline = 0;
+    int next_edge = 0;
+    int count = 0;
+
+    for (uint32_t now = 1; now <= sc->end_ms; now++)
+    {
+        if (armed && now == deadline)
+        {
+            armed = false;
+            gesture_result_t res = gesture_update(&state, sc->cfg, level, now);
+            if (res.timeout_ms)
+            {
+                armed = true;
+                deadline = now + res.timeout_ms;
+            }
+            if (res.gesture != GESTURE_NONE && count < MAX_EVENTS)
+                events[count++] = (event_t){res.gesture, now};
+        }
+
+        if (next_edge < sc->edge_count && sc->edges[next_edge].at_ms == now)
+        {
+            level = sc->edges[next_edge++].pressed;
+            armed = true;
+            deadline = now + DEBOUNCE_MS;
+        }
+    }
+    return count;
+}
+
+static void run(const scenario_t *sc)
+{
+    event_t events[MAX_EVENTS];
+    int count = simulate(sc, events);
+
+    TEST_CHECK(count == sc->expected_count, "gesture %s: %d gestures, expected %d", sc->name, count,
+               sc->expected_count);
+    for (int i = 0; i < count && i < sc->expected_count; i++)
+    {
+        TEST_CHECK(events[i].gesture == sc->expected[i].gesture && events[i].at_ms == sc->expected[i].at_ms,
+                   "gesture %s #%d: %d at %u ms, expected %d at %u ms", sc->name, i, events[i].gesture,
+                   (unsigned)events[i].at_ms, sc->expected[i].gesture, (unsigned)sc->expected[i].at_ms);
+    }
+}
+
+void test_gesture(void)
+{
+    static const gesture_config_t no_double = {.long_press_ms = 1000, .hold_ms = 3000, .double_click_ms = 0};
+
+    static const scenario_t scenarios[] = {
+        // Sampled released at 280, short press once the double-click window has passed
+        {"click", &s_cfg, {{100, true}, {250, false}}, 2, 1000, {{GESTURE_SHORT_PRESS, 580}}, 1},
+        {"click_no_double", &no_double, {{100, true}, {250, false}}, 2, 1000, {{GESTURE_SHORT_PRESS, 280}}, 1},
+        // Second press sampled at 430, 150 ms into the window; its release is ignored
+        {"double_click",
+         &s_cfg,
+         {{100, true}, {200, false}, {400, true}, {500, false}},
+         4,
+         1500,
+         {{GESTURE_DOUBLE_CLICK, 430}},
+         1},
+        // Second press sampled after the window: two separate clicks
+        {"double_click_timeout",
+         &s_cfg,
+         {{100, true}, {200, false}, {700, true}, {800, false}},
+         4,
+         2000,
+         {{GESTURE_SHORT_PRESS, 530}, {GESTURE_SHORT_PRESS, 1130}},
+         2},
+        {"long_press", &s_cfg, {{100, true}, {1500, false}}, 2, 3000, {{GESTURE_LONG_PRESS, 1530}}, 1},
+        // Released just before the long press time: still a click
+        {"long_press_threshold", &no_double, {{100, true}, {1099, false}}, 2, 2000, {{GESTURE_SHORT_PRESS, 1129}}, 1},
+        // Fires while held (press sampled at 130), the release is ignored
+        {"hold", &s_cfg, {{100, true}, {5000, false}}, 2, 6000, {{GESTURE_HOLD, 3130}}, 1},
+        // Contact bounce on press and release: one click, timed from the last bounce
+        {"debounce",
+         &no_double,
+         {{100, true}, {103, false}, {105, true}, {109, false}, {112, true}, {300, false}, {302, true}, {306, false}},
+         8,
+         1000,
+         {{GESTURE_SHORT_PRESS, 336}},
+         1},
+        // Spikes shorter than the debounce time are never sampled
+        {"glitch", &s_cfg, {{100, true}, {110, false}, {500, true}, {529, false}}, 4, 2000, {{0}}, 0},
+        // Bounce while held restarts the debounce but keeps the hold timing
+        {"hold_bounce",
+         &s_cfg,
+         {{100, true}, {2000, false}, {2005, true}, {4000, false}},
+         4,
+         5000,
+         {{GESTURE_HOLD, 3130}},
+         1},
+    };
+
+    for (unsigned i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+        run(&scenarios[i]);
+}
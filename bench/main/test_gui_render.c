@@ -0,0 +1,69 @@
+#include <string.h>
+
+#include "gui_render.h"
+#include "test.h"
+
+#define HOR_RES 8
+
+// Two-page glyphs in SSD1306 layout: page 0 columns first, LSB is the top pixel
+static const uint8_t s_bitmap[] = {
+    0x01, 0x02, 0x80, 0x40, // '1': 2 columns
+    0xFF, 0x0F,             // '°': 1 column
+};
+static const gui_atlas_glyph_t s_glyphs[] = {
+    {'1', 0, 2, 3},
+    {0xB0, 4, 1, 2},
+};
+static const gui_atlas_t s_atlas = {
+    .glyphs = s_glyphs,
+    .count = 2,
+    .pages = 2,
+    .bitmap = s_bitmap,
+};
+
+static void check_pages(const char *what, const uint8_t *got, const uint8_t *expected)
+{
+    TEST_CHECK(memcmp(got, expected, 2 * HOR_RES) == 0,
+               "atlas %s: %02x %02x %02x %02x %02x %02x %02x %02x / %02x %02x %02x %02x %02x %02x %02x %02x", what,
+               got[0], got[1], got[2], got[3], got[4], got[5], got[6], got[7], got[8], got[9], got[10], got[11],
+               got[12], got[13], got[14], got[15]);
+}
+
+// Value line drawing from the glyph atlas, as used by draw_value_line() in gui.c
+void test_gui_render(void)
+{
+    uint8_t pages[2 * HOR_RES];
+
+    // "1°1": the degree sign is two UTF-8 bytes
+    TEST_CHECK(gui_render_atlas_width(&s_atlas, "1°1") == 8, "atlas width: %d",
+               gui_render_atlas_width(&s_atlas, "1°1"));
+    memset(pages, 0, sizeof(pages));
+    gui_render_atlas_text(pages, HOR_RES, &s_atlas, 1, "1°1");
+    check_pages("text", pages,
+                (const uint8_t[]){0x00, 0x01, 0x02, 0x00, 0xFF, 0x00, 0x01, 0x02,
+                                  0x00, 0x80, 0x40, 0x00, 0x0F, 0x00, 0x80, 0x40});
+
+    // Characters without a glyph take no space
+    TEST_CHECK(gui_render_atlas_width(&s_atlas, "1x1") == 6, "atlas width without glyph: %d",
+               gui_render_atlas_width(&s_atlas, "1x1"));
+    memset(pages, 0, sizeof(pages));
+    gui_render_atlas_text(pages, HOR_RES, &s_atlas, 0, "1x1");
+    check_pages("missing glyph", pages,
+                (const uint8_t[]){0x01, 0x02, 0x00, 0x01, 0x02, 0x00, 0x00, 0x00,
+                                  0x80, 0x40, 0x00, 0x80, 0x40, 0x00, 0x00, 0x00});
+
+    // Columns are OR-ed into what is already there
+    memset(pages, 0x10, sizeof(pages));
+    gui_render_atlas_text(pages, HOR_RES, &s_atlas, 0, "1");
+    check_pages("or", pages,
+                (const uint8_t[]){0x11, 0x12, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                  0x90, 0x50, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10});
+
+    // Both screen edges clip
+    memset(pages, 0, sizeof(pages));
+    gui_render_atlas_text(pages, HOR_RES, &s_atlas, -1, "1");
+    gui_render_atlas_text(pages, HOR_RES, &s_atlas, HOR_RES - 1, "1");
+    check_pages("clip", pages,
+                (const uint8_t[]){0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+                                  0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80});
+}
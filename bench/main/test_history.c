@@ -0,0 +1,241 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "history.h"
+#include "test.h"
+
+#define INTERVAL_S 10
+#define MAX_SAMPLES 200
+
+static history_block_t s_blocks[8];
+static history_t s_history;
+
+// Deterministic readings with steps well inside ±12.7
+static int16_t temp_at(unsigned i)
+{
+    return (int16_t)(200 + (int)(i * 7 % 41) - 20);
+}
+
+static uint16_t hum_at(unsigned i)
+{
+    return (uint16_t)(500 + i % 13);
+}
+
+static void reset(uint16_t capacity)
+{
+    memset(&s_history, 0, sizeof(s_history));
+    history_init(&s_history, s_blocks, capacity, INTERVAL_S);
+}
+
+static void add_range(unsigned first, unsigned count)
+{
+    for (unsigned i = first; i < first + count; i++)
+        history_add(&s_history, i * INTERVAL_S, temp_at(i), hum_at(i));
+}
+
+// Reads everything from from_s on, returns the number of samples
+static unsigned read_all(uint32_t from_s, history_sample_t *out)
+{
+    history_cursor_t c;
+    unsigned n = 0;
+    history_seek(&s_history, &c, from_s);
+    while (n < MAX_SAMPLES && history_next(&s_history, &c, &out[n]))
+        n++;
+    return n;
+}
+
+// Checks that out[] holds the generated samples first, first + 1, …
+static void check_samples(const char *what, const history_sample_t *out, unsigned n, unsigned first)
+{
+    for (unsigned k = 0; k < n; k++)
+    {
+        unsigned i = first + k;
+        if (out[k].time_s != i * INTERVAL_S || out[k].temp != temp_at(i) || out[k].hum != hum_at(i))
+        {
+            TEST_CHECK(0, "history %s: sample %u is [%lu,%d,%u], expected [%u,%d,%u]", what, k,
+                       (unsigned long)out[k].time_s, out[k].temp, out[k].hum, i * INTERVAL_S, temp_at(i), hum_at(i));
+            return;
+        }
+    }
+}
+
+static void test_blocks(void)
+{
+    history_sample_t out[MAX_SAMPLES];
+
+    // Full blocks hold 1 + HISTORY_BLOCK_DELTAS samples
+    reset(8);
+    add_range(0, 2 * (HISTORY_BLOCK_DELTAS + 1) + 1);
+    TEST_CHECK(s_history.used == 3, "history: %u blocks for %d samples", s_history.used,
+               2 * (HISTORY_BLOCK_DELTAS + 1) + 1);
+    unsigned n = read_all(0, out);
+    TEST_CHECK(n == 2 * (HISTORY_BLOCK_DELTAS + 1) + 1, "history: read %u samples", n);
+    check_samples("round trip", out, n, 0);
+
+    // A second sample for the newest slot is ignored
+    history_add(&s_history, n * INTERVAL_S - 1, 999, 999);
+    TEST_CHECK(history_count(&s_history) == n, "history: same slot stored, %u samples", history_count(&s_history));
+
+    // A missed slot starts a new block, no sample is invented for it
+    reset(8);
+    history_add(&s_history, 0, 200, 500);
+    history_add(&s_history, 10, 201, 500);
+    history_add(&s_history, 40, 202, 500);
+    n = read_all(0, out);
+    TEST_CHECK(s_history.used == 2 && n == 3 && out[2].time_s == 40 && out[2].temp == 202,
+               "history gap: %u blocks, %u samples, last at %lu", s_history.used, n, (unsigned long)out[n - 1].time_s);
+
+    // ±12.7 still fits into a step, one tenth more starts a new block
+    reset(8);
+    history_add(&s_history, 0, 200, 500);
+    history_add(&s_history, 10, 327, 373);
+    TEST_CHECK(s_history.used == 1, "history: step of 12.7 in %u blocks", s_history.used);
+    history_add(&s_history, 20, 199, 500);
+    TEST_CHECK(s_history.used == 2, "history: temperature step of -12.8 in %u blocks", s_history.used);
+    history_add(&s_history, 30, 199, 629);
+    TEST_CHECK(s_history.used == 3, "history: humidity step of 12.9 in %u blocks", s_history.used);
+    n = read_all(0, out);
+    TEST_CHECK(n == 4 && out[1].temp == 327 && out[1].hum == 373 && out[2].temp == 199 && out[3].hum == 629,
+               "history large steps: %u samples, [%d,%u] [%d,%u] [%d,%u]", n, out[1].temp, out[1].hum, out[2].temp,
+               out[2].hum, out[3].temp, out[3].hum);
+
+    // The clock going backwards clears the history
+    reset(8);
+    add_range(0, 40);
+    history_add(&s_history, 155, 210, 400);
+    n = read_all(0, out);
+    TEST_CHECK(n == 1 && history_oldest(&s_history) == 150 && out[0].temp == 210 && out[0].hum == 400,
+               "history clock reset: %u samples from %lu", n, (unsigned long)history_oldest(&s_history));
+}
+
+static void test_recycle(void)
+{
+    const unsigned per_block = HISTORY_BLOCK_DELTAS + 1;
+    history_sample_t out[MAX_SAMPLES];
+    history_cursor_t c;
+
+    reset(3);
+    add_range(0, 3 * per_block - 1);
+    history_seek(&s_history, &c, 0);
+    for (unsigned i = 0; i < 5; i++)
+        history_next(&s_history, &c, &out[i]);
+
+    // Adding to the newest block leaves the cursor where it was
+    add_range(3 * per_block - 1, 1);
+    TEST_CHECK(history_next(&s_history, &c, &out[5]), "history: cursor lost after an add");
+    check_samples("cursor after add", out, 6, 0);
+
+    // Recycling the block under the cursor continues at the oldest remaining sample
+    add_range(3 * per_block, 2 * per_block);
+    unsigned oldest = history_oldest(&s_history) / INTERVAL_S;
+    TEST_CHECK(oldest == 2 * per_block, "history: oldest sample %u after recycling", oldest);
+    unsigned n = 0;
+    while (n < MAX_SAMPLES && history_next(&s_history, &c, &out[n]))
+        n++;
+    TEST_CHECK(n == history_count(&s_history), "history recycle: read %u of %u samples", n,
+               history_count(&s_history));
+    check_samples("recycle", out, n, oldest);
+
+    // A cursor whose block is still there is not moved
+    reset(3);
+    add_range(0, 3 * per_block);
+    history_seek(&s_history, &c, (2 * per_block + 3) * INTERVAL_S);
+    add_range(3 * per_block, per_block);
+    n = 0;
+    while (n < MAX_SAMPLES && history_next(&s_history, &c, &out[n]))
+        n++;
+    TEST_CHECK(n == 2 * per_block - 3, "history: cursor in a kept block read %u samples", n);
+    check_samples("kept block", out, n, 2 * per_block + 3);
+}
+
+// Parses the samples of one chunk into out[], returns their number or -1
+static int parse_chunk(const char *buf, history_sample_t *out, bool *last)
+{
+    const char *p = strstr(buf, "\"samples\":[");
+    if (!p)
+        return -1;
+    p += strlen("\"samples\":[");
+
+    int n = 0;
+    while (*p == '[' || *p == ',')
+    {
+        unsigned long t;
+        int temp;
+        unsigned hum;
+        int used;
+        if (sscanf(p + (*p == ','), "[%lu,%d,%u]%n", &t, &temp, &hum, &used) != 3)
+            return -1;
+        out[n++] = (history_sample_t){.time_s = t, .temp = temp, .hum = hum};
+        p += (*p == ',') + used;
+    }
+
+    if (strcmp(p, "],\"last\":true}") == 0)
+        *last = true;
+    else if (strcmp(p, "],\"last\":false}") == 0)
+        *last = false;
+    else
+        return -1;
+    return n;
+}
+
+static void test_chunks(void)
+{
+    history_sample_t out[MAX_SAMPLES];
+    history_cursor_t c;
+    char buf[160];
+    bool last;
+
+    reset(8);
+    add_range(0, 100);
+
+    // Every chunk stays within its size and the samples continue across chunks
+    const size_t size = 100;
+    history_seek(&s_history, &c, 0);
+    unsigned total = 0, seq = 0;
+    do
+    {
+        memset(buf, 'x', sizeof(buf));
+        int len = history_chunk(&s_history, &c, UINT32_MAX, "req-1", seq, 1234, buf, size, &last);
+        TEST_CHECK(len > 0 && (size_t)len < size && strlen(buf) == (size_t)len && buf[size] == 'x',
+                   "history chunk %u: length %d of %u", seq, len, (unsigned)size);
+        char head[64];
+        snprintf(head, sizeof(head), "{\"id\":\"req-1\",\"seq\":%u,\"now\":1234,", seq);
+        TEST_CHECK(strncmp(buf, head, strlen(head)) == 0, "history chunk %u: %s", seq, buf);
+
+        bool parsed_last;
+        int n = parse_chunk(buf, out + total, &parsed_last);
+        TEST_CHECK(n >= 0 && parsed_last == last && total + n <= 100, "history chunk %u: %s", seq, buf);
+        if (n < 0 || parsed_last != last || total + n > 100)
+            return;
+        total += n;
+        seq++;
+    } while (!last && seq < 100);
+    TEST_CHECK(total == 100 && last, "history chunks: %u samples in %u chunks", total, seq);
+    check_samples("chunks", out, total, 0);
+
+    // Too small for one sample: nothing is written and the cursor stays
+    history_seek(&s_history, &c, 0);
+    size_t header = strlen("{\"id\":\"req-1\",\"seq\":0,\"now\":1234,\"samples\":[");
+    size_t one = strlen("[0,200,500]");
+    TEST_CHECK(history_chunk(&s_history, &c, UINT32_MAX, "req-1", 0, 1234, buf,
+                             header + one + strlen("],\"last\":false}"), &last) == 0,
+               "history chunk: sample written without room");
+    int len = history_chunk(&s_history, &c, UINT32_MAX, "req-1", 0, 1234, buf,
+                            header + one + strlen("],\"last\":false}") + 1, &last);
+    TEST_CHECK(len > 0 && parse_chunk(buf, out, &last) == 1 && out[0].time_s == 0 && !last,
+               "history chunk: exact fit gave %s", len ? buf : "(empty)");
+
+    // The range ends at to_s
+    history_seek(&s_history, &c, 200);
+    len = history_chunk(&s_history, &c, 250, "r", 0, 0, buf, sizeof(buf), &last);
+    int n = parse_chunk(buf, out, &last);
+    TEST_CHECK(len > 0 && n == 6 && last && out[0].time_s == 200 && out[5].time_s == 250, "history range: %s", buf);
+}
+
+// Delta-encoded history: block boundaries, recycling under a cursor and chunking
+void test_history(void)
+{
+    test_blocks();
+    test_recycle();
+    test_chunks();
+}
@@ -0,0 +1,41 @@
+#include <string.h>
+
+#include "mqtt_payload.h"
+#include "test.h"
+
+// Discovery payloads carry Kconfig strings, which may contain JSON specials
+void test_mqtt_payload(void)
+{
+    const mqtt_discovery_t d = {
+        .name = "Room \"A\" \\ 2\t",
+        .dev_cla = "temperature",
+        .unit = "°C",
+        .val_tpl = "{{ value_json.temperature }}",
+        .uniq_id = "esp32-sensor-AABBCC-temp",
+        .stat_t = "homeassistant/sensor/esp32-sensor-AABBCC/state",
+        .avty_t = "homeassistant/sensor/esp32-sensor-AABBCC/availability",
+        .dev_ids = "esp32-sensor-AABBCC",
+        .dev_name = "Sensor \"Kitchen\\Left\"",
+    };
+    static const char expected[] =
+        "{\"name\":\"Room \\\"A\\\" \\\\ 2\\u0009\",\"dev_cla\":\"temperature\",\"stat_cla\":\"measurement\","
+        "\"unit_of_meas\":\"°C\",\"stat_t\":\"homeassistant/sensor/esp32-sensor-AABBCC/state\","
+        "\"val_tpl\":\"{{ value_json.temperature }}\",\"uniq_id\":\"esp32-sensor-AABBCC-temp\","
+        "\"avty_t\":\"homeassistant/sensor/esp32-sensor-AABBCC/availability\",\"pl_avail\":\"online\","
+        "\"pl_not_avail\":\"offline\",\"dev\":{\"ids\":\"esp32-sensor-AABBCC\","
+        "\"name\":\"Sensor \\\"Kitchen\\\\Left\\\"\",\"mf\":\"Espressif\"}}";
+
+    char buf[512];
+    int len = mqtt_payload_discovery(buf, sizeof(buf), &d);
+    TEST_CHECK(len == (int)strlen(expected) && strcmp(buf, expected) == 0, "mqtt discovery: %s", len ? buf : "(empty)");
+
+    // Escapes count against the buffer: one byte short must fail, not truncate
+    TEST_CHECK(mqtt_payload_discovery(buf, sizeof(expected) - 1, &d) == 0, "mqtt discovery: fits into %d bytes",
+               (int)sizeof(expected) - 1);
+    TEST_CHECK(mqtt_payload_discovery(buf, sizeof(expected), &d) == (int)strlen(expected),
+               "mqtt discovery: %d bytes not enough", (int)sizeof(expected));
+
+    // Without comfort metrics the state payload stays minimal
+    len = mqtt_payload_state(buf, sizeof(buf), 21.5f, 45.0f, NULL);
+    TEST_CHECK(len > 0 && strcmp(buf, "{\"temperature\":21.5,\"humidity\":45.0}") == 0, "mqtt state: %s", buf);
+}
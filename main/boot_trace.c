@@ -0,0 +1,95 @@
+#include "boot_trace.h"
+
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "BOOT";
+
+static const char *const stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_APP_START] = "app_start",
+    [BOOT_STAGE_SENSOR] = "sensor",
+    [BOOT_STAGE_DISPLAY] = "display",
+    [BOOT_STAGE_FIRST_VALUE] = "first_value",
+    [BOOT_STAGE_NVS] = "nvs",
+    [BOOT_STAGE_NETWORK] = "network",
+    [BOOT_STAGE_WIFI_CONNECTED] = "wifi_connected",
+    [BOOT_STAGE_MQTT_CONNECTED] = "mqtt_connected",
+    [BOOT_STAGE_FIRST_PUBLISH] = "first_publish",
+};
+
+// Event group bits are only set after the timestamp is stored,
+// so a reader that sees a bit also sees its time
+static StaticEventGroup_t s_group_struct;
+static EventGroupHandle_t s_group = NULL;
+static atomic_uint s_claimed = 0;
+static int64_t s_time_us[BOOT_STAGE_COUNT];
+
+void boot_trace_init(void)
+{
+    if (s_group)
+        return;
+
+    s_group = xEventGroupCreateStatic(&s_group_struct);
+    boot_trace_mark(BOOT_STAGE_APP_START);
+}
+
+bool boot_trace_mark(boot_stage_t stage)
+{
+    int64_t now = esp_timer_get_time();
+
+    // Several tasks may report the same stage (e.g. every MQTT connect); only the first counts
+    unsigned bit = BOOT_BIT(stage);
+    if (atomic_fetch_or_explicit(&s_claimed, bit, memory_order_relaxed) & bit)
+        return false;
+
+    s_time_us[stage] = now;
+    xEventGroupSetBits(s_group, bit);
+    ESP_LOGI(TAG, "%s at %" PRId64 " ms", stage_names[stage], now / 1000);
+    return true;
+}
+
+bool boot_trace_wait(uint32_t stages, TickType_t timeout)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_group, stages, pdFALSE, pdTRUE, timeout);
+    return (bits & stages) == stages;
+}
+
+void boot_trace_wait_any(uint32_t stages, TickType_t timeout)
+{
+    xEventGroupWaitBits(s_group, stages, pdFALSE, pdFALSE, timeout);
+}
+
+uint32_t boot_trace_pending(uint32_t stages)
+{
+    return stages & ~(uint32_t)xEventGroupGetBits(s_group);
+}
+
+int boot_trace_json(char *buf, size_t size)
+{
+    EventBits_t reached = xEventGroupGetBits(s_group);
+    size_t len = 0;
+    const char *sep = "{";
+
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++)
+    {
+        if (!(reached & BOOT_BIT(i)))
+            continue;
+
+        int n = snprintf(buf + len, size - len, "%s\"%s\":%" PRId64, sep, stage_names[i], s_time_us[i] / 1000);
+        if (n < 0 || (size_t)n >= size - len)
+            return 0;
+        len += n;
+        sep = ",";
+    }
+
+    // No stage at all still yields a valid object
+    int n = snprintf(buf + len, size - len, "%s}", len ? "" : "{");
+    if (n < 0 || (size_t)n >= size - len)
+        return 0;
+    return len + n;
+}
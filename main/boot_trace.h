@@ -0,0 +1,47 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+
+// Boot stages, timestamped with esp_timer_get_time() when first reached.
+// Stages also act as dependencies: a task that needs another stage waits for
+// its bit instead of relying on the order of calls in app_main.
+typedef enum
+{
+    BOOT_STAGE_APP_START,      // app_main entered
+    BOOT_STAGE_SENSOR,         // first sensor read attempted
+    BOOT_STAGE_DISPLAY,        // panel and LVGL ready
+    BOOT_STAGE_FIRST_VALUE,    // first reading on screen
+    BOOT_STAGE_NVS,            // NVS mounted
+    BOOT_STAGE_NETWORK,        // Wi-Fi started (STA or provisioning)
+    BOOT_STAGE_WIFI_CONNECTED, // got an IP address
+    BOOT_STAGE_MQTT_CONNECTED, // broker accepted the connection
+    BOOT_STAGE_FIRST_PUBLISH,  // first state message handed to the client
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+#define BOOT_BIT(stage) (1u << (stage))
+
+// Creates the event group and marks BOOT_STAGE_APP_START (call first in app_main)
+void boot_trace_init(void);
+
+// Records the stage and wakes tasks waiting for it.
+// Returns true the first time, false if the stage was already reached.
+bool boot_trace_mark(boot_stage_t stage);
+
+// Waits until all stages in the BOOT_BIT mask are reached.
+// Returns false on timeout.
+bool boot_trace_wait(uint32_t stages, TickType_t timeout);
+
+// Waits until any stage in the mask is reached (returns at once if one already was).
+// Used to cut a polling delay short while boot is still in progress.
+void boot_trace_wait_any(uint32_t stages, TickType_t timeout);
+
+// Returns the subset of the mask that has not been reached yet
+uint32_t boot_trace_pending(uint32_t stages);
+
+// Builds {"app_start":12,"sensor":15,...} with milliseconds since esp_timer start
+// for every stage reached so far. Returns the length, or 0 if it did not fit.
+int boot_trace_json(char *buf, size_t size);
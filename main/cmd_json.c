@@ -0,0 +1,177 @@
+#include "cmd_json.h"
+
+#include <string.h>
+
+typedef struct
+{
+    const char *p;
+    const char *end;
+} scan_t;
+
+// ---------------- SCANNER ----------------
+
+static void skip_ws(scan_t *s)
+{
+    while (s->p < s->end && (*s->p == ' ' || *s->p == '\t' || *s->p == '\n' || *s->p == '\r'))
+        s->p++;
+}
+
+// Moves past a string starting at the opening quote. Returns false if unterminated.
+static bool skip_string(scan_t *s)
+{
+    for (s->p++; s->p < s->end; s->p++)
+    {
+        if (*s->p == '\\')
+            s->p++;
+        else if (*s->p == '"')
+        {
+            s->p++;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool skip_value(scan_t *s)
+{
+    if (s->p >= s->end)
+        return false;
+    if (*s->p == '"')
+        return skip_string(s);
+
+    if (*s->p == '{' || *s->p == '[')
+    {
+        int depth = 0;
+        while (s->p < s->end)
+        {
+            if (*s->p == '"')
+            {
+                if (!skip_string(s))
+                    return false;
+                continue;
+            }
+            if (*s->p == '{' || *s->p == '[')
+                depth++;
+            else if ((*s->p == '}' || *s->p == ']') && --depth == 0)
+            {
+                s->p++;
+                return true;
+            }
+            s->p++;
+        }
+        return false;
+    }
+
+    // Number or literal
+    const char *start = s->p;
+    while (s->p < s->end && *s->p != ',' && *s->p != '}' && *s->p != ']' && *s->p != ' ' && *s->p != '\t' &&
+           *s->p != '\n' && *s->p != '\r')
+        s->p++;
+    return s->p > start;
+}
+
+// Returns the start of the member's value, or NULL
+static const char *find_member(const char *data, size_t len, const char *key, const char **end)
+{
+    scan_t s = {.p = data, .end = data + len};
+    size_t key_len = strlen(key);
+
+    skip_ws(&s);
+    if (s.p >= s.end || *s.p != '{')
+        return NULL;
+    s.p++;
+
+    while (1)
+    {
+        skip_ws(&s);
+        if (s.p >= s.end || *s.p != '"')
+            return NULL;
+        const char *name = s.p + 1;
+        if (!skip_string(&s))
+            return NULL;
+        bool match = (size_t)(s.p - 1 - name) == key_len && memcmp(name, key, key_len) == 0;
+
+        skip_ws(&s);
+        if (s.p >= s.end || *s.p != ':')
+            return NULL;
+        s.p++;
+        skip_ws(&s);
+
+        if (match)
+        {
+            *end = s.end;
+            return s.p;
+        }
+        if (!skip_value(&s))
+            return NULL;
+
+        skip_ws(&s);
+        if (s.p >= s.end || *s.p != ',')
+            return NULL;
+        s.p++;
+    }
+}
+
+// ---------------- PUBLIC FUNCTIONS ----------------
+
+bool cmd_json_string(const char *data, size_t len, const char *key, char *out, size_t size)
+{
+    const char *end;
+    const char *p = find_member(data, len, key, &end);
+    if (size)
+        out[0] = '\0';
+    if (!p || p >= end || *p != '"' || !size)
+        return false;
+
+    size_t n = 0;
+    for (p++; p < end; p++)
+    {
+        char c = *p;
+        if (c == '"')
+        {
+            out[n] = '\0';
+            return true;
+        }
+        if (c == '\\')
+        {
+            if (++p >= end || (*p != '"' && *p != '\\' && *p != '/'))
+                break;
+            c = *p;
+        }
+        if (n + 1 >= size)
+            break;
+        out[n++] = c;
+    }
+    out[0] = '\0';
+    return false;
+}
+
+bool cmd_json_uint(const char *data, size_t len, const char *key, uint32_t *out)
+{
+    const char *end;
+    const char *p = find_member(data, len, key, &end);
+    if (!p || p >= end || *p < '0' || *p > '9')
+        return false;
+
+    uint64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        value = value * 10 + (*p - '0');
+        if (value > UINT32_MAX)
+            value = UINT32_MAX + 1ULL; // saturate, keeps consuming digits
+    }
+    *out = value > UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+    return true;
+}
+
+bool cmd_json_true(const char *data, size_t len, const char *key)
+{
+    const char *end;
+    const char *p = find_member(data, len, key, &end);
+    if (!p || end - p < 4 || memcmp(p, "true", 4) != 0)
+        return false;
+
+    // The literal must end there ("trueX" is not true)
+    p += 4;
+    return p == end || *p == ',' || *p == '}' || *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r';
+}
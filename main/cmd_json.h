@@ -0,0 +1,19 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Reads top-level members of the small, flat command objects received over
+// MQTT ({"url":"…","delta":true}, {"id":"…","from":0,"to":3600}) in place,
+// without allocating. Nested objects and arrays are skipped, escapes in
+// strings are limited to \" \\ \/. Plain C, no ESP-IDF dependencies.
+
+// Copies a string member into out. Returns false if the member is missing,
+// not a string or does not fit (out is then empty).
+bool cmd_json_string(const char *data, size_t len, const char *key, char *out, size_t size);
+
+// Reads a non-negative integer member (fraction ignored), clamped to UINT32_MAX
+bool cmd_json_uint(const char *data, size_t len, const char *key, uint32_t *out);
+
+// Returns true only if the member exists and is the literal true
+bool cmd_json_true(const char *data, size_t len, const char *key);
@@ -0,0 +1,82 @@
+#include "comfort.h"
+
+#include "comfort_lut.h"
+
+#define CLAMP(v, lo, hi) ((v) < (lo) ? (lo) : (v) > (hi) ? (hi) : (v))
+// Rounded division for b > 0
+#define RDIV(a, b) (((a) >= 0 ? (a) + (b) / 2 : (a) - (b) / 2) / (b))
+
+#define T_TABLE_LEN (COMFORT_T_MAX - COMFORT_T_MIN + 1)
+#define HI_T_LEN (COMFORT_HI_T_MAX - COMFORT_HI_T_MIN + 1)
+#define HI_RH_LEN (100 / COMFORT_HI_RH_STEP + 1)
+#define LN_RH_LEN ((int)(sizeof(comfort_ln_rh) / sizeof(comfort_ln_rh[0])))
+
+// Linear interpolation in a 1 °C table at 0.1 °C resolution
+static int32_t interp_t(const int32_t *table, int t10)
+{
+    t10 = CLAMP(t10, COMFORT_T_MIN * 10, COMFORT_T_MAX * 10);
+    int off = t10 - COMFORT_T_MIN * 10;
+    int i = off / 10;
+    int frac = off % 10;
+
+    if (i == T_TABLE_LEN - 1)
+        return table[i];
+    return table[i] + (table[i + 1] - table[i]) * frac / 10;
+}
+
+// ln(RH / 100) in Q12
+static int32_t ln_rh(int h10)
+{
+    h10 = CLAMP(h10, 1, 1000);
+    if (h10 < COMFORT_RH_LOW10)
+        return comfort_ln_rh_low[h10];
+
+    int off = h10 - COMFORT_RH_LOW10;
+    int i = off / COMFORT_RH_STEP10;
+    int frac = off % COMFORT_RH_STEP10;
+    if (i == LN_RH_LEN - 1)
+        return comfort_ln_rh[i];
+    return comfort_ln_rh[i] + (comfort_ln_rh[i + 1] - comfort_ln_rh[i]) * frac / COMFORT_RH_STEP10;
+}
+
+int16_t comfort_dew_point(int t10, int h10)
+{
+    // gamma = ln(RH/100) + b*T/(c+T), Td = c*gamma / (b - gamma)
+    int32_t gamma = ln_rh(h10) + interp_t(comfort_magnus_t, t10);
+    int32_t td100 = RDIV(COMFORT_MAGNUS_C100 * gamma, COMFORT_MAGNUS_B_Q - gamma);
+    return (int16_t)RDIV(td100, 10);
+}
+
+int32_t comfort_abs_humidity(int t10, int h10)
+{
+    // Saturation vapour density (mg/m³) scaled by relative humidity
+    int32_t svd = interp_t(comfort_svd, t10);
+    return RDIV(svd * CLAMP(h10, 0, 1000), 10000);
+}
+
+int16_t comfort_heat_index(int t10, int h10)
+{
+    // Neither substituting the air temperature below nor clamping above the
+    // table is the NOAA value, so nothing is reported there
+    if (t10 < COMFORT_HI_T_MIN * 10 || t10 > COMFORT_HI_T_MAX * 10)
+        return COMFORT_HI_NONE;
+
+    // Bilinear interpolation in the 1 °C x 5 % table
+    int tc = t10 - COMFORT_HI_T_MIN * 10;
+    int rc = CLAMP(h10, 0, 1000);
+    int ti = tc / 10, tf = tc % 10;
+    int ri = rc / (COMFORT_HI_RH_STEP * 10), rf = rc % (COMFORT_HI_RH_STEP * 10);
+    int ti1 = ti + 1 < HI_T_LEN ? ti + 1 : ti;
+    int ri1 = ri + 1 < HI_RH_LEN ? ri + 1 : ri;
+
+    int32_t a = comfort_hi_table[ri][ti] * 10 + (comfort_hi_table[ri][ti1] - comfort_hi_table[ri][ti]) * tf;
+    int32_t b = comfort_hi_table[ri1][ti] * 10 + (comfort_hi_table[ri1][ti1] - comfort_hi_table[ri1][ti]) * tf;
+    return (int16_t)RDIV(a * (COMFORT_HI_RH_STEP * 10) + (b - a) * rf, COMFORT_HI_RH_STEP * 10 * 10);
+}
+
+void comfort_compute(int t10, int h10, comfort_t *out)
+{
+    out->dew_point_c10 = comfort_dew_point(t10, h10);
+    out->abs_humidity_g100 = comfort_abs_humidity(t10, h10);
+    out->heat_index_c10 = comfort_heat_index(t10, h10);
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stdint.h>
+
+// Derived comfort metrics in fixed point (no logf/expf, the ESP32-C3 has no FPU).
+// Inputs are the sensor's native resolution: temperature in 0.1 °C, humidity in 0.1 %.
+// Error bounds against the reference formulas are listed in comfort_lut.h.
+
+typedef struct
+{
+    int16_t dew_point_c10;       // Magnus dew point, 0.1 °C
+    int32_t abs_humidity_g100;   // absolute humidity, 0.01 g/m³
+    int16_t heat_index_c10;      // NOAA heat index, 0.1 °C, or COMFORT_HI_NONE
+} comfort_t;
+
+// Heat index outside its 20..50 °C table range (published as null)
+#define COMFORT_HI_NONE INT16_MIN
+
+// Dew point in 0.1 °C (humidity below 0.1 % is clamped)
+int16_t comfort_dew_point(int t10, int h10);
+
+// Absolute humidity in 0.01 g/m³
+int32_t comfort_abs_humidity(int t10, int h10);
+
+// Heat index in 0.1 °C for 20..50 °C, COMFORT_HI_NONE outside that range
+int16_t comfort_heat_index(int t10, int h10);
+
+// All of the above
+void comfort_compute(int t10, int h10, comfort_t *out);
@@ -0,0 +1,115 @@
+#pragma once
+// Generated by tools/gen_comfort_lut.py - do not edit.
+//
+// Maximum error against the double-precision reference over -40..80 °C, 1..100 %:
+//   dew point          0.064 °C
+//   absolute humidity  0.048 g/m³
+//   heat index         0.965 °C (20..50 °C; 99 % of inputs within 0.215 °C,
+//                      the maximum sits at the NOAA switch from the simple formula to Rothfusz)
+
+#include <stdint.h>
+
+#define COMFORT_Q 12
+#define COMFORT_MAGNUS_B_Q 72172
+#define COMFORT_MAGNUS_C100 24312
+
+#define COMFORT_T_MIN -40
+#define COMFORT_T_MAX 80
+#define COMFORT_RH_STEP10 5
+#define COMFORT_RH_LOW10 100
+#define COMFORT_HI_T_MIN 20
+#define COMFORT_HI_T_MAX 50
+#define COMFORT_HI_RH_STEP 5
+
+// ln(RH / 100) in Q12, RH = 0..9.9 % in 0.1 % steps (entry 0 clamps to 0.1 %)
+static const int16_t comfort_ln_rh_low[100] = {
+    -28294, -28294, -25455, -23794, -22616, -21702, -20955, -20324, -19777, -19294, -18863, -18472,
+    -18116, -17788, -17485, -17202, -16938, -16689, -16455, -16234, -16024, -15824, -15633, -15451,
+    -15277, -15110, -14949, -14794, -14645, -14502, -14363, -14229, -14099, -13972, -13850, -13731,
+    -13616, -13504, -13395, -13288, -13185, -13083, -12985, -12888, -12794, -12702, -12612, -12524,
+    -12438, -12353, -12271, -12189, -12110, -12032, -11955, -11880, -11806, -11734, -11663, -11593,
+    -11524, -11456, -11389, -11324, -11259, -11196, -11133, -11072, -11011, -10951, -10892, -10834,
+    -10777, -10720, -10665, -10610, -10555, -10502, -10449, -10397, -10345, -10295, -10244, -10195,
+    -10146, -10097, -10049, -10002, -9955, -9909, -9863, -9818, -9773, -9729, -9685, -9641,
+    -9599, -9556, -9514, -9473,
+};
+
+// ln(RH / 100) in Q12, RH = 10..100 % in 0.5 % steps
+static const int16_t comfort_ln_rh[181] = {
+    -9431, -9232, -9041, -8859, -8685, -8517, -8357, -8202, -8053, -7909, -7771, -7636,
+    -7506, -7380, -7258, -7139, -7024, -6912, -6802, -6696, -6592, -6491, -6392, -6296,
+    -6202, -6110, -6020, -5932, -5845, -5761, -5678, -5597, -5518, -5440, -5363, -5288,
+    -5214, -5142, -5070, -5000, -4931, -4864, -4797, -4732, -4667, -4604, -4541, -4479,
+    -4419, -4359, -4300, -4242, -4185, -4128, -4072, -4017, -3963, -3910, -3857, -3805,
+    -3753, -3702, -3652, -3602, -3553, -3505, -3457, -3410, -3363, -3316, -3271, -3225,
+    -3181, -3136, -3093, -3049, -3006, -2964, -2922, -2880, -2839, -2798, -2758, -2718,
+    -2678, -2639, -2600, -2562, -2524, -2486, -2449, -2412, -2375, -2339, -2302, -2267,
+    -2231, -2196, -2161, -2127, -2092, -2058, -2025, -1991, -1958, -1925, -1892, -1860,
+    -1828, -1796, -1764, -1733, -1702, -1671, -1640, -1610, -1580, -1550, -1520, -1490,
+    -1461, -1432, -1403, -1374, -1346, -1317, -1289, -1261, -1233, -1206, -1178, -1151,
+    -1124, -1097, -1071, -1044, -1018, -992, -966, -940, -914, -888, -863, -838,
+    -813, -788, -763, -739, -714, -690, -666, -642, -618, -594, -570, -547,
+    -524, -500, -477, -454, -432, -409, -386, -364, -342, -319, -297, -275,
+    -253, -232, -210, -189, -167, -146, -125, -104, -83, -62, -41, -21,
+    0,
+};
+
+// b * T / (c + T) in Q12, T = -40..80 °C
+static const int32_t comfort_magnus_t[121] = {
+    -14213, -13789, -13370, -12955, -12544, -12137, -11734, -11335, -10939, -10547, -10159, -9775,
+    -9394, -9016, -8642, -8272, -7905, -7541, -7181, -6823, -6469, -6118, -5771, -5426,
+    -5084, -4746, -4410, -4077, -3747, -3420, -3096, -2774, -2456, -2140, -1826, -1515,
+    -1207, -902, -599, -298, 0, 296, 589, 880, 1168, 1454, 1738, 2020,
+    2299, 2576, 2851, 3124, 3395, 3663, 3930, 4194, 4456, 4717, 4975, 5231,
+    5486, 5738, 5989, 6238, 6484, 6729, 6973, 7214, 7454, 7691, 7927, 8162,
+    8394, 8625, 8855, 9082, 9308, 9533, 9756, 9977, 10197, 10415, 10631, 10846,
+    11060, 11272, 11483, 11692, 11900, 12106, 12311, 12514, 12717, 12917, 13117, 13315,
+    13512, 13707, 13901, 14094, 14286, 14476, 14665, 14853, 15040, 15225, 15409, 15592,
+    15774, 15955, 16134, 16313, 16490, 16666, 16841, 17015, 17188, 17360, 17530, 17700,
+    17869,
+};
+
+// Saturation vapour density in mg/m³, T = -40..80 °C
+static const int32_t comfort_svd[121] = {
+    177, 195, 215, 237, 261, 287, 316, 347,
+    380, 417, 456, 499, 545, 595, 650, 708,
+    772, 840, 914, 993, 1078, 1170, 1269, 1375,
+    1489, 1611, 1741, 1882, 2032, 2192, 2364, 2547,
+    2743, 2952, 3174, 3412, 3665, 3934, 4220, 4525,
+    4849, 5193, 5558, 5945, 6356, 6792, 7253, 7741,
+    8258, 8805, 9383, 9994, 10639, 11320, 12039, 12797,
+    13597, 14439, 15326, 16260, 17243, 18277, 19364, 20507,
+    21707, 22968, 24291, 25680, 27136, 28663, 30264, 31941,
+    33697, 35535, 37459, 39471, 41576, 43775, 46074, 48475,
+    50983, 53600, 56332, 59181, 62152, 65250, 68478, 71841,
+    75343, 78990, 82785, 86734, 90842, 95113, 99553, 104168,
+    108962, 113941, 119111, 124478, 130048, 135826, 141819, 148033,
+    154475, 161150, 168066, 175230, 182649, 190328, 198277, 206502,
+    215010, 223809, 232907, 242312, 252032, 262075, 272449, 283162,
+    294224,
+};
+
+// Heat index in 0.1 °C, rows RH = 0..100 % (5 % steps), columns T = 20..50 °C
+static const int16_t comfort_hi_table[21][31] = {
+    {181, 192, 203, 214, 225, 236, 247, 258, 258, 265, 272, 280, 287, 294, 301, 307, 316, 324, 332, 340, 347, 355, 363, 370, 379, 388, 393, 398, 402, 406, 410},
+    {182, 193, 204, 215, 226, 237, 248, 259, 261, 268, 275, 282, 290, 297, 305, 312, 321, 329, 338, 347, 356, 364, 373, 382, 392, 402, 410, 418, 426, 433, 441},
+    {183, 194, 205, 216, 227, 238, 249, 260, 264, 271, 279, 286, 294, 302, 311, 319, 328, 338, 347, 357, 367, 377, 388, 398, 410, 421, 432, 443, 454, 466, 477},
+    {184, 195, 206, 217, 228, 239, 250, 261, 266, 274, 281, 289, 298, 307, 316, 326, 336, 346, 357, 368, 380, 392, 405, 418, 431, 445, 459, 473, 488, 503, 519},
+    {186, 197, 208, 219, 230, 241, 252, 263, 267, 275, 282, 291, 300, 309, 320, 330, 342, 354, 367, 380, 394, 408, 423, 439, 455, 472, 490, 508, 527, 546, 566},
+    {187, 198, 209, 220, 231, 242, 253, 262, 269, 276, 284, 293, 303, 314, 325, 337, 350, 364, 379, 395, 411, 428, 446, 465, 484, 505, 526, 548, 571, 594, 619},
+    {188, 199, 210, 221, 232, 243, 254, 264, 271, 279, 288, 297, 308, 320, 333, 347, 362, 378, 394, 412, 431, 451, 472, 494, 517, 541, 566, 592, 620, 648, 677},
+    {190, 201, 212, 223, 234, 245, 256, 266, 274, 282, 292, 303, 315, 328, 343, 358, 375, 393, 413, 433, 455, 478, 503, 528, 555, 583, 612, 642, 674, 706, 740},
+    {191, 202, 213, 224, 235, 246, 257, 269, 277, 286, 297, 309, 323, 338, 354, 372, 391, 412, 434, 458, 483, 509, 537, 566, 596, 628, 662, 696, 733, 770, 809},
+    {192, 203, 214, 225, 236, 247, 258, 271, 280, 291, 303, 317, 332, 349, 368, 388, 410, 434, 459, 485, 513, 543, 575, 608, 642, 679, 716, 756, 797, 839, 884},
+    {194, 205, 216, 227, 238, 249, 260, 274, 284, 297, 310, 326, 344, 363, 384, 407, 431, 458, 486, 516, 548, 581, 617, 654, 693, 733, 776, 820, 866, 914, 964},
+    {195, 206, 217, 228, 239, 250, 261, 277, 289, 303, 319, 337, 356, 378, 402, 427, 455, 485, 516, 550, 585, 623, 662, 704, 747, 792, 840, 889, 940, 994, 1049},
+    {196, 207, 218, 229, 240, 251, 262, 281, 294, 310, 328, 348, 371, 395, 422, 451, 481, 514, 550, 587, 626, 668, 712, 758, 806, 856, 909, 963, 1020, 1079, 1140},
+    {198, 209, 220, 231, 242, 253, 264, 285, 300, 318, 339, 362, 387, 414, 444, 476, 510, 547, 586, 627, 671, 717, 765, 816, 869, 924, 982, 1042, 1104, 1169, 1236},
+    {199, 210, 221, 232, 243, 254, 265, 289, 307, 327, 350, 376, 404, 435, 468, 503, 542, 582, 625, 671, 719, 770, 823, 878, 936, 997, 1060, 1126, 1194, 1264, 1337},
+    {200, 211, 222, 233, 244, 255, 266, 293, 314, 337, 363, 392, 423, 457, 494, 533, 575, 620, 667, 718, 770, 826, 884, 945, 1008, 1074, 1143, 1214, 1288, 1365, 1444},
+    {201, 212, 223, 234, 245, 256, 267, 297, 321, 347, 377, 409, 444, 481, 522, 565, 612, 661, 713, 768, 825, 886, 949, 1015, 1084, 1156, 1230, 1308, 1388, 1471, 1557},
+    {203, 214, 225, 236, 247, 258, 269, 302, 329, 359, 391, 427, 466, 508, 552, 600, 651, 704, 761, 821, 883, 949, 1018, 1089, 1164, 1242, 1322, 1406, 1493, 1582, 1675},
+    {204, 215, 226, 237, 248, 259, 270, 311, 340, 372, 408, 447, 490, 535, 584, 637, 692, 751, 812, 877, 945, 1016, 1090, 1168, 1249, 1332, 1419, 1509, 1602, 1699, 1798},
+    {205, 216, 227, 238, 249, 260, 271, 320, 352, 387, 425, 468, 515, 565, 619, 676, 736, 800, 866, 937, 1010, 1087, 1167, 1251, 1337, 1427, 1521, 1617, 1717, 1821, 1927},
+    {207, 218, 229, 240, 251, 262, 273, 329, 364, 402, 444, 490, 542, 597, 655, 717, 782, 851, 924, 999, 1079, 1161, 1248, 1337, 1430, 1527, 1627, 1730, 1837, 1948, 2062},
+};
@@ -38,11 +38,94 @@
 #define THRESHOLD_TEMP (CONFIG_THRESHOLD_TEMP * 0.1f)
 #define THRESHOLD_HUM (CONFIG_THRESHOLD_HUM * 0.1f)
 
+#if CONFIG_COMFORT_METRICS
+#define COMFORT_METRICS 1
+#else
+#define COMFORT_METRICS 0
+#endif
+
+// ============ MQTT TLS CONFIGURATION ============
+
+#if CONFIG_MQTT_TLS_ENABLE
+#define MQTT_TLS_ENABLE 1
+#else
+#define MQTT_TLS_ENABLE 0
+#endif
+
+#if CONFIG_MQTT_TLS_SESSION_RESUMPTION
+#define MQTT_TLS_SESSION_RESUMPTION 1
+#else
+#define MQTT_TLS_SESSION_RESUMPTION 0
+#endif
+
+// ============ HTTP STATUS CONFIGURATION ============
+
+#if CONFIG_HTTP_STATUS_ENABLE
+#define HTTP_STATUS_ENABLE 1
+#define HTTP_STATUS_PORT CONFIG_HTTP_STATUS_PORT
+#define HTTP_STATUS_MAX_SOCKETS CONFIG_HTTP_STATUS_MAX_SOCKETS
+#else
+#define HTTP_STATUS_ENABLE 0
+#endif
+
+// ============ HISTORY CONFIGURATION ============
+
+#if CONFIG_HISTORY_ENABLE
+#define HISTORY_ENABLE 1
+#define HISTORY_HOURS CONFIG_HISTORY_HOURS
+#define HISTORY_INTERVAL_S CONFIG_HISTORY_INTERVAL_S
+#define HISTORY_CHUNK_SIZE CONFIG_HISTORY_CHUNK_SIZE
+#define HISTORY_WINDOW CONFIG_HISTORY_WINDOW
+#else
+#define HISTORY_ENABLE 0
+#endif
+
+#if CONFIG_HISTORY_RTC
+#define HISTORY_RTC 1
+#else
+#define HISTORY_RTC 0
+#endif
+
+// ============ LOGGING CONFIGURATION ============
+
+#if CONFIG_TLOG_ENABLE
+#define TLOG_ENABLE 1
+#define TLOG_RING_SIZE CONFIG_TLOG_RING_SIZE
+#else
+#define TLOG_ENABLE 0
+#endif
+
+// ============ OTA CONFIGURATION ============
+
+#define OTA_HEALTH_TIMEOUT_S CONFIG_OTA_HEALTH_TIMEOUT_S
+#define OTA_RECV_BUFFER_SIZE CONFIG_OTA_RECV_BUFFER_SIZE
+
+// ============ MEMORY CONFIGURATION ============
+
+#if CONFIG_MEM_BUDGET_LOG
+#define MEM_BUDGET_LOG 1
+#else
+#define MEM_BUDGET_LOG 0
+#endif
+
+#define LVGL_TASK_STACK_SIZE CONFIG_LVGL_TASK_STACK_SIZE
+#define BUTTON_TASK_STACK_SIZE CONFIG_BUTTON_TASK_STACK_SIZE
+#define OTA_TASK_STACK_SIZE CONFIG_OTA_TASK_STACK_SIZE
+#define MQTT_BUFFER_SIZE CONFIG_MQTT_BUFFER_SIZE
+#define MQTT_OUTBOX_LIMIT CONFIG_MQTT_OUTBOX_LIMIT
+
 // ============ HARDWARE PIN CONFIGURATION ============
 
 #define BUTTON_GPIO CONFIG_BUTTON_GPIO
 #define BUTTON_ACTIVE_LEVEL CONFIG_BUTTON_ACTIVE_LEVEL
 
+// Button gestures (milliseconds)
+#define BUTTON_DEBOUNCE_MS CONFIG_BUTTON_DEBOUNCE_MS
+#define BUTTON_LONG_PRESS_MS CONFIG_BUTTON_LONG_PRESS_MS
+#define BUTTON_HOLD_MS CONFIG_BUTTON_HOLD_MS
+#define BUTTON_DOUBLE_CLICK_MS CONFIG_BUTTON_DOUBLE_CLICK_MS
+_Static_assert(BUTTON_HOLD_MS > BUTTON_LONG_PRESS_MS, "Button hold time must be longer than the long press time");
+
 // ============ GUI CONFIGURATION ============
 
 // I2C settings for display
@@ -57,6 +140,19 @@
 #define LCD_V_RES CONFIG_LCD_V_RES
 #define LCD_PIXEL_CLOCK_HZ CONFIG_LCD_PIXEL_CLOCK_HZ
 
+// Generated fonts (tools/gen_fonts.py)
+#if CONFIG_GUI_FONT_SUBSET
+#define GUI_FONT_SUBSET 1
+#else
+#define GUI_FONT_SUBSET 0
+#endif
+
+#if CONFIG_GUI_GLYPH_ATLAS
+#define GUI_GLYPH_ATLAS 1
+#else
+#define GUI_GLYPH_ATLAS 0
+#endif
+
 // ============ SENSOR CONFIGURATION ============
 
 // DHT sensor GPIO pin
@@ -0,0 +1,117 @@
+#include "device_state.h"
+
+#include <stdatomic.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if defined(ESP_PLATFORM) && !CONFIG_IDF_TARGET_LINUX
+#include "freertos/FreeRTOS.h"
+
+// Writers run with interrupts disabled, so a reader can never preempt a
+// half-finished write on a single core and spin against it
+static portMUX_TYPE s_write_lock = portMUX_INITIALIZER_UNLOCKED;
+#define WRITE_LOCK() portENTER_CRITICAL(&s_write_lock)
+#define WRITE_UNLOCK() portEXIT_CRITICAL(&s_write_lock)
+#else
+// Host build (tests, benchmarks, linux target): writers may be plain
+// pthreads, which the critical sections of the FreeRTOS POSIX port don't cover
+static atomic_flag s_write_lock = ATOMIC_FLAG_INIT;
+#define WRITE_LOCK()                                                              \
+    while (atomic_flag_test_and_set_explicit(&s_write_lock, memory_order_acquire)) \
+    {                                                                             \
+    }
+#define WRITE_UNLOCK() atomic_flag_clear_explicit(&s_write_lock, memory_order_release)
+#endif
+
+// Odd while a write is in progress
+static atomic_uint s_seq = 0;
+static device_state_t s_state = {
+    .display_enabled = true,
+};
+
+static void write_begin(void)
+{
+    WRITE_LOCK();
+    unsigned seq = atomic_load_explicit(&s_seq, memory_order_relaxed);
+    atomic_store_explicit(&s_seq, seq + 1, memory_order_relaxed);
+    // Make the odd sequence visible before any field changes
+    atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(void)
+{
+    s_state.version++;
+    unsigned seq = atomic_load_explicit(&s_seq, memory_order_relaxed);
+    atomic_store_explicit(&s_seq, seq + 1, memory_order_release);
+    WRITE_UNLOCK();
+}
+
+void device_state_get(device_state_t *out)
+{
+    while (1)
+    {
+        unsigned seq0 = atomic_load_explicit(&s_seq, memory_order_acquire);
+        if (seq0 & 1)
+            continue; // writer active
+
+        *out = *(const volatile device_state_t *)&s_state;
+
+        // Field loads must complete before the sequence is checked again
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&s_seq, memory_order_relaxed) == seq0)
+            return;
+    }
+}
+
+uint32_t device_state_version(void)
+{
+    // Each completed write advances the sequence by two
+    return atomic_load_explicit(&s_seq, memory_order_acquire) >> 1;
+}
+
+void device_state_set_wifi_connected(bool connected)
+{
+    write_begin();
+    s_state.wifi_connected = connected;
+    write_end();
+}
+
+void device_state_set_mqtt_connected(bool connected)
+{
+    write_begin();
+    s_state.mqtt_connected = connected;
+    write_end();
+}
+
+void device_state_set_display_enabled(bool enabled)
+{
+    write_begin();
+    s_state.display_enabled = enabled;
+    write_end();
+}
+
+void device_state_set_sample(float temperature, float humidity, int64_t time_us)
+{
+    write_begin();
+    s_state.sample_valid = true;
+    s_state.temperature = temperature;
+    s_state.humidity = humidity;
+    s_state.sample_time_us = time_us;
+    write_end();
+}
+
+void device_state_set_sample_error(void)
+{
+    write_begin();
+    s_state.sample_valid = false;
+    write_end();
+}
+
+void device_state_set_last_send(int64_t time_us)
+{
+    write_begin();
+    s_state.last_send_time_us = time_us;
+    write_end();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Shared device state, written through a seqlock.
+// Any task can take a consistent snapshot without locks; readers never block
+// writers and never see a half-written record.
+
+typedef struct
+{
+    uint32_t version; // incremented on every write
+
+    // Connectivity
+    bool wifi_connected;
+    bool mqtt_connected;
+
+    // Display
+    bool display_enabled;
+
+    // Latest sensor reading
+    bool sample_valid;
+    float temperature;
+    float humidity;
+    int64_t sample_time_us;
+
+    // Last successful MQTT publish
+    int64_t last_send_time_us;
+} device_state_t;
+
+// Copies a consistent snapshot of the current state (lock-free, retries on concurrent writes)
+void device_state_get(device_state_t *out);
+
+// Returns the current version without copying the record
+uint32_t device_state_version(void);
+
+// Writers (serialised internally, safe from any task)
+void device_state_set_wifi_connected(bool connected);
+void device_state_set_mqtt_connected(bool connected);
+void device_state_set_display_enabled(bool enabled);
+void device_state_set_sample(float temperature, float humidity, int64_t time_us);
+void device_state_set_sample_error(void);
+void device_state_set_last_send(int64_t time_us);
@@ -0,0 +1,80 @@
+#include "gesture.h"
+
+static void enter(gesture_state_t *state, gesture_state_id_t id, uint32_t now_ms)
+{
+    state->id = id;
+    state->since_ms = now_ms;
+}
+
+gesture_result_t gesture_update(gesture_state_t *state, const gesture_config_t *cfg, bool pressed, uint32_t now_ms)
+{
+    gesture_result_t res = {GESTURE_NONE, 0};
+    // Unsigned difference stays correct across the 32-bit millisecond wrap
+    uint32_t elapsed = now_ms - state->since_ms;
+
+    switch (state->id)
+    {
+    case GESTURE_STATE_IDLE:
+        if (pressed)
+        {
+            enter(state, GESTURE_STATE_PRESSED, now_ms);
+            res.timeout_ms = cfg->hold_ms;
+        }
+        break;
+
+    case GESTURE_STATE_PRESSED:
+        if (pressed)
+        {
+            if (elapsed >= cfg->hold_ms)
+            {
+                res.gesture = GESTURE_HOLD;
+                enter(state, GESTURE_STATE_WAIT_RELEASE, now_ms);
+            }
+            else
+            {
+                res.timeout_ms = cfg->hold_ms - elapsed;
+            }
+        }
+        else if (elapsed >= cfg->long_press_ms)
+        {
+            res.gesture = GESTURE_LONG_PRESS;
+            enter(state, GESTURE_STATE_IDLE, now_ms);
+        }
+        else if (cfg->double_click_ms == 0)
+        {
+            res.gesture = GESTURE_SHORT_PRESS;
+            enter(state, GESTURE_STATE_IDLE, now_ms);
+        }
+        else
+        {
+            enter(state, GESTURE_STATE_WAIT_SECOND, now_ms);
+            res.timeout_ms = cfg->double_click_ms;
+        }
+        break;
+
+    case GESTURE_STATE_WAIT_SECOND:
+        if (pressed)
+        {
+            // Reported on the second press, the release is ignored
+            res.gesture = GESTURE_DOUBLE_CLICK;
+            enter(state, GESTURE_STATE_WAIT_RELEASE, now_ms);
+        }
+        else if (elapsed >= cfg->double_click_ms)
+        {
+            res.gesture = GESTURE_SHORT_PRESS;
+            enter(state, GESTURE_STATE_IDLE, now_ms);
+        }
+        else
+        {
+            res.timeout_ms = cfg->double_click_ms - elapsed;
+        }
+        break;
+
+    case GESTURE_STATE_WAIT_RELEASE:
+        if (!pressed)
+            enter(state, GESTURE_STATE_IDLE, now_ms);
+        break;
+    }
+
+    return res;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Button gesture recognition as a pure state machine.
+// No ESP-IDF dependencies, so it can be compiled and unit-tested on the host.
+
+typedef enum
+{
+    GESTURE_NONE = 0,
+    GESTURE_SHORT_PRESS,  // released before long_press_ms, no second click followed
+    GESTURE_DOUBLE_CLICK, // second press within double_click_ms after a short press
+    GESTURE_LONG_PRESS,   // released after long_press_ms but before hold_ms
+    GESTURE_HOLD,         // still held after hold_ms (fires while the button is down)
+} gesture_t;
+
+typedef struct
+{
+    uint32_t long_press_ms;
+    uint32_t hold_ms;
+    uint32_t double_click_ms; // 0 disables double-click (short press fires on release)
+} gesture_config_t;
+
+typedef enum
+{
+    GESTURE_STATE_IDLE = 0,
+    GESTURE_STATE_PRESSED,      // first press, waiting for release or hold
+    GESTURE_STATE_WAIT_SECOND,  // released after a short press, waiting for a second click
+    GESTURE_STATE_WAIT_RELEASE, // gesture already reported, ignore until released
+} gesture_state_id_t;
+
+typedef struct
+{
+    gesture_state_id_t id;
+    uint32_t since_ms; // time of the last transition
+} gesture_state_t;
+
+typedef struct
+{
+    gesture_t gesture;   // recognised gesture, or GESTURE_NONE
+    uint32_t timeout_ms; // call gesture_update again after this time (0 = only on the next edge)
+} gesture_result_t;
+
+// Advances the state machine with the debounced button level at time now_ms.
+// Call on every debounced edge and whenever the returned timeout expires.
+// Repeated calls with an unchanged level are harmless.
+gesture_result_t gesture_update(gesture_state_t *state, const gesture_config_t *cfg, bool pressed, uint32_t now_ms);
@@ -1,10 +1,14 @@
 #include "gui.h"
 
+#include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/lock.h>
 #include <unistd.h>
 
 #include "config.h"
+#include "device_state.h"
+#include "gui_render.h"
 #include "driver/i2c_master.h"
 #include "esp_err.h"
 #include "esp_lcd_panel_io.h"
@@ -15,6 +19,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "lvgl.h"
+#include "mem_budget.h"
 
 // ================= CONFIGURATION =================
 #define I2C_BUS_PORT CONFIG_I2C_BUS_PORT
@@ -30,16 +35,17 @@
 
 // LVGL Settings
 #define LVGL_TICK_PERIOD_MS 5
-#define LVGL_TASK_STACK_SIZE (4 * 1024)
+#define LVGL_TASK_STACK_SIZE CONFIG_LVGL_TASK_STACK_SIZE
 #define LVGL_TASK_PRIORITY 2
 
 // Global variables for UI widgets
 static lv_obj_t *label_status = NULL;
-static lv_obj_t *label_temp = NULL;
+#if !GUI_GLYPH_ATLAS
+static lv_obj_t *label_temp = NULL; // the atlas draws the value line itself
+#endif
 
 // Display state tracking
 static esp_lcd_panel_handle_t g_panel_handle = NULL;
-static bool g_display_enabled = true;
 
 // Mutex for thread safety
 static _lock_t lvgl_api_lock;
@@ -47,10 +53,33 @@ static _lock_t lvgl_api_lock;
 // Buffer for monochrome conversion
 static uint8_t oled_buffer[LCD_H_RES * LCD_V_RES / 8];
 
+// LVGL draw buffer (I1 format + palette)
+#define DRAW_BUFFER_SIZE (LCD_H_RES * LCD_V_RES / 8 + 8)
+#if CONFIG_STATIC_MEMORY
+static uint8_t draw_buffer[DRAW_BUFFER_SIZE];
+#endif
+
 static const char *TAG = "GUI";
 
+#if GUI_FONT_SUBSET
+#include "gui_fonts.h"
+#define FONT_STATUS (&gui_font_status)
+#else
 LV_FONT_DECLARE(lv_font_montserrat_10);
 LV_FONT_DECLARE(lv_font_montserrat_14);
+#define FONT_STATUS (&lv_font_montserrat_10)
+#endif
+
+#if GUI_GLYPH_ATLAS
+// Value line drawn from the glyph atlas, outside LVGL. It sits where the
+// centred label used to be and is laid over every LVGL frame in the flush.
+#define VALUE_PAGE (LCD_V_RES / 16)
+static uint8_t value_pages[LCD_H_RES * LCD_V_RES / 8];
+static int value_page_count = 0;
+#endif
+
+// Set by the flush callback, so the LVGL task can time frames that were sent
+static bool frame_flushed = false;
 
 // ---------------- INTERNAL HELPER FUNCTIONS ----------------
 
@@ -76,22 +105,12 @@ static void lvgl_flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px
     int y1 = area->y1;
     int y2 = area->y2;
 
-    for (int y = y1; y <= y2; y++)
-    {
-        for (int x = x1; x <= x2; x++)
-        {
-            bool chroma_color = (px_map[(hor_res >> 3) * y + (x >> 3)] & 1 << (7 - x % 8));
-            uint8_t *buf = oled_buffer + hor_res * (y >> 3) + (x);
-            if (chroma_color)
-            {
-                (*buf) &= ~(1 << (y % 8));
-            }
-            else
-            {
-                (*buf) |= (1 << (y % 8));
-            }
-        }
-    }
+    gui_render_convert_i1(oled_buffer, px_map, hor_res, x1, y1, x2, y2);
+#if GUI_GLYPH_ATLAS
+    // Full render mode: every flush covers the whole screen
+    memcpy(oled_buffer + VALUE_PAGE * hor_res, value_pages, value_page_count * hor_res);
+#endif
+    frame_flushed = true;
     esp_lcd_panel_draw_bitmap(panel_handle, x1, y1, x2 + 1, y2 + 1, oled_buffer);
 }
 
@@ -109,7 +128,13 @@ static void lvgl_port_task(void *arg)
     while (1)
     {
         _lock_acquire(&lvgl_api_lock);
+        int64_t start = esp_timer_get_time();
         time_till_next_ms = lv_timer_handler();
+        if (frame_flushed)
+        {
+            frame_flushed = false;
+            ESP_LOGD(TAG, "Frame rendered and sent in %" PRId64 " us", esp_timer_get_time() - start);
+        }
         _lock_release(&lvgl_api_lock);
 
         if (time_till_next_ms > 500)
@@ -121,20 +146,51 @@ static void lvgl_port_task(void *arg)
     }
 }
 
+#if GUI_GLYPH_ATLAS
+// Redraws the value rows and sends only those pages (call with the LVGL lock held).
+// The panel's transfer-done callback reports a flush LVGL did not start; that is
+// harmless because the lock guarantees LVGL is not waiting for one.
+static void draw_value_line(const char *text)
+{
+    int64_t start = esp_timer_get_time();
+
+    memset(value_pages, 0, sizeof(value_pages));
+    int x = (LCD_H_RES - gui_render_atlas_width(&gui_atlas, text)) / 2;
+    gui_render_atlas_text(value_pages, LCD_H_RES, &gui_atlas, x, text);
+
+    int64_t drawn = esp_timer_get_time();
+    esp_lcd_panel_draw_bitmap(g_panel_handle, 0, VALUE_PAGE * 8, LCD_H_RES, (VALUE_PAGE + value_page_count) * 8,
+                              value_pages);
+
+    ESP_LOGD(TAG, "Value line drawn in %" PRId64 " us, sent in %" PRId64 " us", drawn - start,
+             esp_timer_get_time() - drawn);
+}
+#endif
+
 static void setup_ui(void)
 {
     lv_obj_t *scr = lv_screen_active();
 
     // Status label (top)
     label_status = lv_label_create(scr);
-    lv_obj_set_style_text_font(label_status, &lv_font_montserrat_10, 0);
+    lv_obj_set_style_text_font(label_status, FONT_STATUS, 0);
     lv_label_set_text(label_status, "Booting...");
     lv_obj_align(label_status, LV_ALIGN_TOP_MID, 0, 0);
 
-    // Temperature and Humidity label (center)
+    // Temperature and Humidity (center)
+#if GUI_GLYPH_ATLAS
+    value_page_count = gui_atlas.pages;
+    if (value_page_count > LCD_V_RES / 8 - VALUE_PAGE)
+        value_page_count = LCD_V_RES / 8 - VALUE_PAGE;
+    draw_value_line("--.-°C --%");
+#else
     label_temp = lv_label_create(scr);
+#if GUI_FONT_SUBSET
+    lv_obj_set_style_text_font(label_temp, &gui_font_value, 0);
+#endif
     lv_label_set_text(label_temp, "--.-°C --%");
     lv_obj_align(label_temp, LV_ALIGN_CENTER, 0, 8);
+#endif
 }
 
 // ---------------- PUBLIC FUNCTIONS ----------------
@@ -190,10 +246,13 @@ void gui_init(void)
     lv_display_set_user_data(display, panel_handle);
 
     // Buffer setup
-    size_t draw_buffer_sz = LCD_H_RES * LCD_V_RES / 8 + 8; // + palette size
-    void *buf = heap_caps_calloc(1, draw_buffer_sz, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#if CONFIG_STATIC_MEMORY
+    void *buf = draw_buffer;
+#else
+    void *buf = heap_caps_calloc(1, DRAW_BUFFER_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#endif
     lv_display_set_color_format(display, LV_COLOR_FORMAT_I1);
-    lv_display_set_buffers(display, buf, NULL, draw_buffer_sz, LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_buffers(display, buf, NULL, DRAW_BUFFER_SIZE, LV_DISPLAY_RENDER_MODE_FULL);
     lv_display_set_flush_cb(display, lvgl_flush_cb);
 
     // Register flush ready callback
@@ -214,28 +273,23 @@ void gui_init(void)
     _lock_release(&lvgl_api_lock);
 
     // Start task
-    xTaskCreate(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, NULL, LVGL_TASK_PRIORITY, NULL);
+    APP_TASK_CREATE(lvgl_port_task, "LVGL", LVGL_TASK_STACK_SIZE, LVGL_TASK_PRIORITY);
 }
 
 void gui_set_values(float temperature, float humidity)
 {
+    char text[32];
+    gui_render_format_values(text, sizeof(text), temperature, humidity);
+
     _lock_acquire(&lvgl_api_lock);
+#if GUI_GLYPH_ATLAS
+    // The boot sequence may report a reading before the panel is up
+    if (label_status)
+        draw_value_line(text);
+#else
     if (label_temp)
-    {
-        // Format temperature and humidity
-        int t_int = (int)temperature;
-        int t_dec = (int)((temperature - t_int) * 10);
-        if (t_dec < 0)
-            t_dec = -t_dec;
-
-        int h_int = (int)humidity;
-        int h_dec = (int)((humidity - h_int) * 10);
-        if (h_dec < 0)
-            h_dec = -h_dec;
-
-        // lv_label_set_text_fmt(label_temp, "%d.%d°C  %d%%", t_int, t_dec, h_int);
-        lv_label_set_text_fmt(label_temp, "%d.%d°C %d.%d%%", t_int, t_dec, h_int, h_dec);
-    }
+        lv_label_set_text(label_temp, text);
+#endif
     _lock_release(&lvgl_api_lock);
 }
 
@@ -253,25 +307,27 @@ void gui_set_status(const char *status_text)
 
 void gui_turn_off(void)
 {
-    if (g_panel_handle && g_display_enabled)
+    if (g_panel_handle && gui_is_enabled())
     {
         ESP_LOGI(TAG, "Turning off display");
         esp_lcd_panel_disp_on_off(g_panel_handle, false);
-        g_display_enabled = false;
+        device_state_set_display_enabled(false);
     }
 }
 
 void gui_turn_on(void)
 {
-    if (g_panel_handle && !g_display_enabled)
+    if (g_panel_handle && !gui_is_enabled())
     {
         ESP_LOGI(TAG, "Turning on display");
         esp_lcd_panel_disp_on_off(g_panel_handle, true);
-        g_display_enabled = true;
+        device_state_set_display_enabled(true);
     }
 }
 
 bool gui_is_enabled(void)
 {
-    return g_display_enabled;
+    device_state_t state;
+    device_state_get(&state);
+    return state.display_enabled;
 }
@@ -0,0 +1,11 @@
+#pragma once
+#include "gui_render.h"
+#include "lvgl.h"
+
+// Generated at build time by tools/gen_fonts.py (CONFIG_GUI_FONT_SUBSET):
+// 1-bpp Montserrat subsets holding only the characters the UI can show.
+extern const lv_font_t gui_font_status; // Montserrat 10, status line
+extern const lv_font_t gui_font_value;  // Montserrat 14, value line
+
+// The value font prerendered in SSD1306 page layout
+extern const gui_atlas_t gui_atlas;
@@ -0,0 +1,110 @@
+#include "gui_render.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void gui_render_convert_i1(uint8_t *dst, const uint8_t *px_map, int hor_res, int x1, int y1, int x2, int y2)
+{
+    for (int y = y1; y <= y2; y++)
+    {
+        for (int x = x1; x <= x2; x++)
+        {
+            bool chroma_color = (px_map[(hor_res >> 3) * y + (x >> 3)] & 1 << (7 - x % 8));
+            uint8_t *buf = dst + hor_res * (y >> 3) + (x);
+            if (chroma_color)
+            {
+                (*buf) &= ~(1 << (y % 8));
+            }
+            else
+            {
+                (*buf) |= (1 << (y % 8));
+            }
+        }
+    }
+}
+
+int gui_render_format_values(char *buf, size_t size, float temperature, float humidity)
+{
+    // Format temperature and humidity
+    int t_int = (int)temperature;
+    int t_dec = (int)((temperature - t_int) * 10);
+    if (t_dec < 0)
+        t_dec = -t_dec;
+
+    int h_int = (int)humidity;
+    int h_dec = (int)((humidity - h_int) * 10);
+    if (h_dec < 0)
+        h_dec = -h_dec;
+
+    return snprintf(buf, size, "%d.%d°C %d.%d%%", t_int, t_dec, h_int, h_dec);
+}
+
+// Decodes one UTF-8 sequence (the UI only uses BMP characters)
+static uint32_t next_codepoint(const char **text)
+{
+    const uint8_t *s = (const uint8_t *)*text;
+    uint32_t cp = s[0];
+    int len = 1;
+
+    if (cp >= 0xE0 && s[1] && s[2])
+    {
+        cp = (cp & 0x0F) << 12 | (s[1] & 0x3F) << 6 | (s[2] & 0x3F);
+        len = 3;
+    }
+    else if (cp >= 0xC0 && s[1])
+    {
+        cp = (cp & 0x1F) << 6 | (s[1] & 0x3F);
+        len = 2;
+    }
+    *text += len;
+    return cp;
+}
+
+static int compare_glyph(const void *key, const void *elem)
+{
+    uint32_t cp = *(const uint32_t *)key;
+    uint32_t other = ((const gui_atlas_glyph_t *)elem)->codepoint;
+    return (cp > other) - (cp < other);
+}
+
+static const gui_atlas_glyph_t *find_glyph(const gui_atlas_t *atlas, uint32_t cp)
+{
+    return bsearch(&cp, atlas->glyphs, atlas->count, sizeof(atlas->glyphs[0]), compare_glyph);
+}
+
+int gui_render_atlas_width(const gui_atlas_t *atlas, const char *text)
+{
+    int width = 0;
+    while (*text)
+    {
+        const gui_atlas_glyph_t *g = find_glyph(atlas, next_codepoint(&text));
+        if (g)
+            width += g->advance;
+    }
+    return width;
+}
+
+void gui_render_atlas_text(uint8_t *dst, int hor_res, const gui_atlas_t *atlas, int x, const char *text)
+{
+    while (*text)
+    {
+        const gui_atlas_glyph_t *g = find_glyph(atlas, next_codepoint(&text));
+        if (!g)
+            continue;
+
+        // Glyph columns may reach into the next cell, so OR instead of copy
+        const uint8_t *src = atlas->bitmap + g->offset;
+        for (int page = 0; page < atlas->pages; page++)
+        {
+            uint8_t *row = dst + page * hor_res;
+            for (int col = 0; col < g->width; col++)
+            {
+                int px = x + col;
+                if (px >= 0 && px < hor_res)
+                    row[px] |= src[page * g->width + col];
+            }
+        }
+        x += g->advance;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Pure rendering helpers used by gui.c.
+// No LVGL or ESP-IDF dependencies, so they also build for the host benchmarks.
+
+// Converts an LVGL I1 pixel map (palette already skipped, row-major, MSB first)
+// into the SSD1306 page layout (one byte = 8 vertical pixels) for the given area.
+// Set pixels become dark on the panel, matching the inverted I1 palette.
+void gui_render_convert_i1(uint8_t *dst, const uint8_t *px_map, int hor_res, int x1, int y1, int x2, int y2);
+
+// Formats the value line shown on the display, e.g. "21.5°C 45.0%".
+// Returns the length like snprintf.
+int gui_render_format_values(char *buf, size_t size, float temperature, float humidity);
+
+// Glyph atlas in SSD1306 page layout (generated by tools/gen_fonts.py).
+// Each glyph is stored page by page, width bytes per page, LSB = top pixel.
+typedef struct
+{
+    uint32_t codepoint;
+    uint16_t offset;  // into bitmap
+    uint8_t width;    // columns stored
+    uint8_t advance;  // pen advance in pixels
+} gui_atlas_glyph_t;
+
+typedef struct
+{
+    const gui_atlas_glyph_t *glyphs; // sorted by codepoint
+    uint16_t count;
+    uint8_t pages;                   // glyph height in 8-pixel pages
+    const uint8_t *bitmap;
+} gui_atlas_t;
+
+// Width in pixels of a UTF-8 string drawn with the atlas
+int gui_render_atlas_width(const gui_atlas_t *atlas, const char *text);
+
+// ORs a UTF-8 string into a page buffer (atlas->pages pages of hor_res bytes)
+// starting at column x. Characters missing from the atlas are skipped.
+void gui_render_atlas_text(uint8_t *dst, int hor_res, const gui_atlas_t *atlas, int x, const char *text);
@@ -0,0 +1,249 @@
+#include "history.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define HISTORY_MAGIC 0x48495331 // "HIS1", bump when history_block_t changes
+
+_Static_assert(sizeof(history_block_t) == 64, "history_block_t should fill one 64-byte block");
+
+// Closing part of a chunk, reserved while samples are added
+#define CHUNK_TAIL "],\"last\":false}"
+
+// ---------------- INTERNAL HELPERS ----------------
+
+static uint16_t oldest_block(const history_t *h)
+{
+    return (h->newest + h->capacity - h->used + 1) % h->capacity;
+}
+
+static bool in_use(const history_t *h, uint16_t block)
+{
+    return h->used && (block + h->capacity - oldest_block(h)) % h->capacity < h->used;
+}
+
+static uint32_t sample_time(const history_t *h, const history_block_t *b, unsigned index)
+{
+    return b->start_s + index * h->interval_s;
+}
+
+// Value of sample index, summing the steps from the block start
+static void block_value(const history_block_t *b, unsigned index, int16_t *temp, uint16_t *hum)
+{
+    int t = b->temp;
+    int u = b->hum;
+    for (unsigned i = 0; i < index; i++)
+    {
+        t += b->delta[i][0];
+        u += b->delta[i][1];
+    }
+    *temp = t;
+    *hum = u;
+}
+
+static void start_block(history_t *h, uint32_t slot_s, int16_t temp, uint16_t hum)
+{
+    if (h->used)
+        h->newest = (h->newest + 1) % h->capacity;
+    if (h->used < h->capacity)
+        h->used++;
+
+    history_block_t *b = &h->blocks[h->newest];
+    memset(b, 0, sizeof(*b));
+    b->start_s = slot_s;
+    b->temp = temp;
+    b->hum = hum;
+    b->count = 1;
+}
+
+// ---------------- WRITING ----------------
+
+bool history_init(history_t *h, history_block_t *blocks, uint16_t capacity, uint16_t interval_s)
+{
+    h->blocks = blocks;
+    if (h->magic == HISTORY_MAGIC && h->capacity == capacity && h->interval_s == interval_s &&
+        h->newest < capacity && h->used <= capacity)
+        return true;
+
+    h->magic = HISTORY_MAGIC;
+    h->capacity = capacity;
+    h->interval_s = interval_s;
+    history_clear(h);
+    return false;
+}
+
+void history_clear(history_t *h)
+{
+    h->newest = 0;
+    h->used = 0;
+}
+
+void history_add(history_t *h, uint32_t time_s, int16_t temp, uint16_t hum)
+{
+    uint32_t slot_s = time_s - time_s % h->interval_s;
+
+    if (!h->used)
+    {
+        start_block(h, slot_s, temp, hum);
+        return;
+    }
+
+    history_block_t *b = &h->blocks[h->newest];
+    uint32_t last_s = sample_time(h, b, b->count - 1);
+    if (slot_s == last_s)
+        return;
+    if (slot_s < last_s)
+    {
+        history_clear(h);
+        start_block(h, slot_s, temp, hum);
+        return;
+    }
+
+    int16_t last_temp;
+    uint16_t last_hum;
+    block_value(b, b->count - 1, &last_temp, &last_hum);
+    int dt = temp - last_temp;
+    int dh = hum - last_hum;
+
+    if (slot_s == last_s + h->interval_s && b->count <= HISTORY_BLOCK_DELTAS && dt >= -127 && dt <= 127 &&
+        dh >= -127 && dh <= 127)
+    {
+        b->delta[b->count - 1][0] = dt;
+        b->delta[b->count - 1][1] = dh;
+        b->count++;
+    }
+    else
+    {
+        start_block(h, slot_s, temp, hum);
+    }
+}
+
+// ---------------- READING ----------------
+
+unsigned history_count(const history_t *h)
+{
+    unsigned count = 0;
+    for (uint16_t i = 0, block = oldest_block(h); i < h->used; i++, block = (block + 1) % h->capacity)
+        count += h->blocks[block].count;
+    return count;
+}
+
+uint32_t history_oldest(const history_t *h)
+{
+    return h->used ? h->blocks[oldest_block(h)].start_s : 0;
+}
+
+void history_seek(const history_t *h, history_cursor_t *c, uint32_t from_s)
+{
+    c->next_s = from_s;
+    c->valid = h->used > 0;
+    if (!c->valid)
+        return;
+
+    // Past the newest sample the cursor waits at the end of the newest block
+    uint16_t block = h->newest;
+    for (uint16_t i = 0, candidate = oldest_block(h); i < h->used; i++, candidate = (candidate + 1) % h->capacity)
+    {
+        const history_block_t *b = &h->blocks[candidate];
+        if (sample_time(h, b, b->count - 1) >= from_s)
+        {
+            block = candidate;
+            break;
+        }
+    }
+
+    const history_block_t *b = &h->blocks[block];
+    unsigned index = 0;
+    if (from_s > b->start_s)
+        index = (from_s - b->start_s + h->interval_s - 1) / h->interval_s;
+    if (index > b->count)
+        index = b->count;
+
+    c->block = block;
+    c->start_s = b->start_s;
+    c->index = index;
+    if (index)
+        block_value(b, index - 1, &c->temp, &c->hum);
+}
+
+bool history_next(const history_t *h, history_cursor_t *c, history_sample_t *out)
+{
+    // The block under the cursor was recycled or the history cleared
+    if (!c->valid || !in_use(h, c->block) || h->blocks[c->block].start_s != c->start_s)
+    {
+        history_seek(h, c, c->next_s);
+        if (!c->valid)
+            return false;
+    }
+
+    while (1)
+    {
+        const history_block_t *b = &h->blocks[c->block];
+        if (c->index < b->count)
+        {
+            if (c->index == 0)
+            {
+                c->temp = b->temp;
+                c->hum = b->hum;
+            }
+            else
+            {
+                c->temp += b->delta[c->index - 1][0];
+                c->hum += b->delta[c->index - 1][1];
+            }
+            out->time_s = sample_time(h, b, c->index);
+            out->temp = c->temp;
+            out->hum = c->hum;
+            c->index++;
+            c->next_s = out->time_s + h->interval_s;
+            return true;
+        }
+
+        if (c->block == h->newest)
+            return false;
+        c->block = (c->block + 1) % h->capacity;
+        c->start_s = h->blocks[c->block].start_s;
+        c->index = 0;
+    }
+}
+
+int history_chunk(const history_t *h, history_cursor_t *c, uint32_t to_s, const char *id, unsigned seq,
+                  uint32_t now_s, char *buf, size_t size, bool *last)
+{
+    const size_t tail = sizeof(CHUNK_TAIL); // includes the terminator
+    int len = snprintf(buf, size, "{\"id\":\"%s\",\"seq\":%u,\"now\":%lu,\"samples\":[", id, seq,
+                       (unsigned long)now_s);
+    if (len < 0 || (size_t)len + tail > size)
+        return 0;
+
+    unsigned written = 0;
+    *last = false;
+    while (1)
+    {
+        // Only advance the real cursor once the sample is in the buffer
+        history_cursor_t next = *c;
+        history_sample_t s;
+        if (!history_next(h, &next, &s) || s.time_s > to_s)
+        {
+            *last = true;
+            break;
+        }
+
+        char item[40];
+        int n = snprintf(item, sizeof(item), "%s[%lu,%d,%u]", written ? "," : "", (unsigned long)s.time_s, s.temp,
+                         s.hum);
+        if ((size_t)(len + n) + tail > size)
+            break;
+
+        memcpy(buf + len, item, n);
+        len += n;
+        written++;
+        *c = next;
+    }
+
+    if (!written && !*last)
+        return 0;
+
+    len += snprintf(buf + len, size - len, "],\"last\":%s}", *last ? "true" : "false");
+    return len;
+}
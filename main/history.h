@@ -0,0 +1,83 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Sample history in fixed-point tenths, delta-encoded in fixed-size blocks.
+// Samples sit on a fixed time grid (interval_s); a block holds one absolute
+// sample and up to HISTORY_BLOCK_DELTAS 8-bit steps. A missed slot or a step
+// beyond ±12.7 starts a new block, the oldest block is recycled when full.
+// Plain C without ESP-IDF dependencies (host benchmarks); not thread-safe.
+
+#define HISTORY_BLOCK_DELTAS 26
+
+typedef struct
+{
+    uint32_t start_s; // time of the first sample (multiple of interval_s)
+    int16_t temp;     // first sample, 0.1 °C
+    uint16_t hum;     // first sample, 0.1 %
+    uint8_t count;    // samples in the block, 1 + deltas used
+    uint8_t reserved[3];
+    int8_t delta[HISTORY_BLOCK_DELTAS][2]; // temperature and humidity steps
+} history_block_t; // 64 bytes
+
+typedef struct
+{
+    uint32_t magic; // layout and settings check, for storage that survives a reset
+    uint16_t interval_s;
+    uint16_t capacity; // blocks
+    uint16_t newest;   // block being filled
+    uint16_t used;     // blocks holding samples
+    history_block_t *blocks;
+} history_t;
+
+typedef struct
+{
+    uint32_t time_s;
+    int16_t temp; // 0.1 °C
+    uint16_t hum; // 0.1 %
+} history_sample_t;
+
+// Read position, stays valid while samples are added: a cursor whose block
+// was recycled continues at the oldest remaining sample
+typedef struct
+{
+    bool valid;
+    uint16_t block;
+    uint32_t start_s; // identifies the block
+    uint8_t index;    // next sample within the block
+    int16_t temp;     // value of the sample before index
+    uint16_t hum;
+    uint32_t next_s; // where to continue if the block is gone
+} history_cursor_t;
+
+// Blocks needed to hold the given span without gaps
+#define HISTORY_BLOCKS_FOR(span_s, interval_s) \
+    (((span_s) / (interval_s) + HISTORY_BLOCK_DELTAS) / (HISTORY_BLOCK_DELTAS + 1) + 1)
+
+// Attaches the storage. Keeps its content if it was written with the same
+// layout and settings (returns true), otherwise starts empty.
+bool history_init(history_t *h, history_block_t *blocks, uint16_t capacity, uint16_t interval_s);
+
+void history_clear(history_t *h);
+
+// Stores a sample in the slot of time_s. A second sample for the same slot is
+// ignored; time going backwards (clock reset) clears the history.
+void history_add(history_t *h, uint32_t time_s, int16_t temp, uint16_t hum);
+
+// Number of samples and time of the oldest one (0 if empty)
+unsigned history_count(const history_t *h);
+uint32_t history_oldest(const history_t *h);
+
+// Positions the cursor on the first sample at or after from_s
+void history_seek(const history_t *h, history_cursor_t *c, uint32_t from_s);
+
+// Returns the sample under the cursor and advances, false at the end
+bool history_next(const history_t *h, history_cursor_t *c, history_sample_t *out);
+
+// Builds one chunk of at most size bytes with the samples up to to_s:
+// {"id":"…","seq":0,"now":123,"samples":[[t,temp,hum],…],"last":false}
+// Advances the cursor past the samples written and sets *last when the range
+// is exhausted. Returns the length, or 0 if not even one sample fits.
+int history_chunk(const history_t *h, history_cursor_t *c, uint32_t to_s, const char *id, unsigned seq,
+                  uint32_t now_s, char *buf, size_t size, bool *last);
@@ -0,0 +1,332 @@
+#include "history_helper.h"
+
+#include "config.h"
+
+#if HISTORY_ENABLE
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "cmd_json.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "history.h"
+#include "mem_budget.h"
+#include "mqtt_helper.h"
+
+static const char *TAG = "HISTORY";
+
+#define HISTORY_TASK_PRIORITY 2 // below the MQTT task, so acknowledgements are handled first
+#define HISTORY_TASK_STACK_SIZE 3072
+#define HISTORY_ACK_TIMEOUT_MS 10000
+#define HISTORY_ID_MAX 32
+#define HISTORY_CAPACITY HISTORY_BLOCKS_FOR(HISTORY_HOURS * 3600, HISTORY_INTERVAL_S)
+
+// PUBLISH header, topic (96-byte buffer in mqtt_helper.c) and message id around the chunk
+#define HISTORY_MSG_OVERHEAD (5 + 2 + 96 + 2)
+_Static_assert(HISTORY_CHUNK_SIZE + HISTORY_MSG_OVERHEAD <= MQTT_BUFFER_SIZE,
+               "History chunk size plus topic must fit into the MQTT buffer size");
+
+// RTC slow/fast memory keeps its content through deep sleep (not through a reset)
+#if HISTORY_RTC
+#define HISTORY_STORAGE RTC_DATA_ATTR
+#else
+#define HISTORY_STORAGE
+#endif
+
+static HISTORY_STORAGE history_t s_history;
+static HISTORY_STORAGE history_block_t s_blocks[HISTORY_CAPACITY];
+
+// Guards s_history between the main loop (writer) and the streaming task
+static StaticSemaphore_t s_lock_struct;
+static SemaphoreHandle_t s_lock = NULL;
+
+// Message ids the stream published and that were not acknowledged yet. An
+// acknowledgement can be handled before its id is added (the MQTT task has the
+// higher priority), so ids without a match are kept for one window as well.
+// Acknowledgements of other publishes never get past on_published.
+static portMUX_TYPE s_ids_lock = portMUX_INITIALIZER_UNLOCKED;
+static int s_in_flight[HISTORY_WINDOW];
+static int s_in_flight_count = 0;
+static int s_unmatched[HISTORY_WINDOW];
+static unsigned s_unmatched_next = 0;
+
+// Acknowledged stream ids; at most HISTORY_WINDOW are in flight, so it never overflows
+static StaticQueue_t s_acks_struct;
+static uint8_t s_acks_storage[HISTORY_WINDOW * sizeof(int)];
+static QueueHandle_t s_acks = NULL;
+
+static TaskHandle_t s_task = NULL;
+static volatile bool s_streaming = false;
+
+// Current request (one at a time, written before the task is notified)
+static char s_id[HISTORY_ID_MAX];
+static uint32_t s_from_s;
+static uint32_t s_to_s;
+
+static char s_chunk[HISTORY_CHUNK_SIZE];
+
+// Device clock in seconds: time since power-on unless set, keeps running through deep sleep
+static uint32_t clock_s(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec;
+}
+
+// ---------------- STREAMING ----------------
+
+// Removes msg_id from ids[], returns false if it is not there. Caller holds s_ids_lock.
+static bool take_id(int *ids, int *count, int msg_id)
+{
+    for (int i = 0; i < *count; i++)
+    {
+        if (ids[i] == msg_id)
+        {
+            ids[i] = ids[--*count];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void reset_ids(void)
+{
+    portENTER_CRITICAL(&s_ids_lock);
+    s_in_flight_count = 0;
+    for (int i = 0; i < HISTORY_WINDOW; i++)
+        s_unmatched[i] = -1;
+    s_unmatched_next = 0;
+    portEXIT_CRITICAL(&s_ids_lock);
+    xQueueReset(s_acks);
+}
+
+// Records a published chunk. Returns false if it was already acknowledged.
+static bool add_in_flight(int msg_id)
+{
+    bool acked = false;
+    portENTER_CRITICAL(&s_ids_lock);
+    for (int i = 0; i < HISTORY_WINDOW; i++)
+    {
+        if (s_unmatched[i] == msg_id)
+        {
+            s_unmatched[i] = -1;
+            acked = true;
+            break;
+        }
+    }
+    if (!acked)
+        s_in_flight[s_in_flight_count++] = msg_id;
+    portEXIT_CRITICAL(&s_ids_lock);
+    return !acked;
+}
+
+// Waits for one acknowledgement of the stream.
+// Returns false on timeout (broker gone or connection lost).
+static bool wait_ack(int *in_flight_count)
+{
+    int msg_id;
+    if (xQueueReceive(s_acks, &msg_id, pdMS_TO_TICKS(HISTORY_ACK_TIMEOUT_MS)) != pdTRUE)
+        return false;
+    --*in_flight_count;
+    return true;
+}
+
+static void stream(void)
+{
+    int in_flight_count = 0;
+    unsigned seq = 0, bytes = 0;
+    int64_t held_us = 0, held_max_us = 0;
+    bool last = false;
+
+    history_cursor_t cursor;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    history_seek(&s_history, &cursor, s_from_s);
+    xSemaphoreGive(s_lock);
+
+    int64_t start = esp_timer_get_time();
+    while (!last)
+    {
+        // Flow control: at most HISTORY_WINDOW chunks unacknowledged
+        while (in_flight_count >= HISTORY_WINDOW)
+        {
+            if (!wait_ack(&in_flight_count))
+            {
+                ESP_LOGE(TAG, "Stream %s aborted after %u chunks: no acknowledgement", s_id, seq);
+                return;
+            }
+        }
+
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        int len = history_chunk(&s_history, &cursor, s_to_s, s_id, seq, clock_s(), s_chunk, sizeof(s_chunk), &last);
+        xSemaphoreGive(s_lock);
+        if (!len)
+        {
+            ESP_LOGE(TAG, "Chunk size too small for one sample");
+            return;
+        }
+
+        // The client is locked while the message is written to the socket
+        int64_t publish_start = esp_timer_get_time();
+        int msg_id = mqtt_helper_publish_history(s_chunk, len);
+        int64_t held = esp_timer_get_time() - publish_start;
+        if (msg_id < 0)
+        {
+            ESP_LOGE(TAG, "Stream %s aborted after %u chunks: not connected", s_id, seq);
+            return;
+        }
+
+        if (add_in_flight(msg_id))
+            in_flight_count++;
+        held_us += held;
+        if (held > held_max_us)
+            held_max_us = held;
+        bytes += len;
+        seq++;
+    }
+
+    while (in_flight_count)
+    {
+        if (!wait_ack(&in_flight_count))
+        {
+            ESP_LOGE(TAG, "Stream %s: last chunks not acknowledged", s_id);
+            return;
+        }
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "Stream %s: %u chunks, %u bytes in %" PRId64 " ms (%" PRId64 " B/s), client held %" PRId64
+             " us (max %" PRId64 " us per chunk)",
+             s_id, seq, bytes, elapsed_us / 1000, elapsed_us ? (int64_t)bytes * 1000000 / elapsed_us : 0, held_us,
+             held_max_us);
+}
+
+static void history_task(void *arg)
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        reset_ids();
+        stream();
+        s_streaming = false;
+    }
+}
+
+// ---------------- PUBLIC FUNCTIONS ----------------
+
+void history_helper_init(void)
+{
+    if (s_lock)
+        return;
+
+    s_lock = xSemaphoreCreateMutexStatic(&s_lock_struct);
+    s_acks = xQueueCreateStatic(HISTORY_WINDOW, sizeof(int), s_acks_storage, &s_acks_struct);
+
+    bool restored = history_init(&s_history, s_blocks, HISTORY_CAPACITY, HISTORY_INTERVAL_S);
+    ESP_LOGI(TAG, "%u blocks (%u bytes), %s", (unsigned)HISTORY_CAPACITY, (unsigned)sizeof(s_blocks),
+             restored ? "restored" : "empty");
+    if (restored)
+        ESP_LOGI(TAG, "%u samples since %" PRIu32 " s", history_count(&s_history), history_oldest(&s_history));
+
+    s_task = APP_TASK_CREATE(history_task, "history", HISTORY_TASK_STACK_SIZE, HISTORY_TASK_PRIORITY);
+    if (!s_task)
+        ESP_LOGE(TAG, "Could not start history task");
+}
+
+void history_helper_add_sample(float temp, float hum)
+{
+    if (!s_lock)
+        return;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    history_add(&s_history, clock_s(), lroundf(temp * 10.0f), lroundf(hum * 10.0f));
+    xSemaphoreGive(s_lock);
+}
+
+void history_helper_handle_command(const char *data, int len)
+{
+    // Runs in the MQTT task: parse, hand over, return
+    int64_t start = esp_timer_get_time();
+
+    if (!s_task || s_streaming)
+    {
+        ESP_LOGW(TAG, "History request ignored, %s", s_task ? "stream in progress" : "no task");
+        return;
+    }
+
+    if (len < 2 || data[0] != '{')
+    {
+        ESP_LOGE(TAG, "Invalid history request");
+        return;
+    }
+
+    // Parsed in place: no heap use per request
+    char id[HISTORY_ID_MAX];
+    cmd_json_string(data, len, "id", id, sizeof(id));
+    if (!cmd_json_uint(data, len, "from", &s_from_s))
+        s_from_s = 0;
+    if (!cmd_json_uint(data, len, "to", &s_to_s))
+        s_to_s = UINT32_MAX;
+
+    // The id is echoed into JSON, so only plain characters are kept
+    size_t n = 0;
+    for (const char *p = id; *p && n < sizeof(s_id) - 1; p++)
+    {
+        if ((*p >= '0' && *p <= '9') || (*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || *p == '-' ||
+            *p == '_')
+            s_id[n++] = *p;
+    }
+    s_id[n] = '\0';
+
+    s_streaming = true;
+    xTaskNotifyGive(s_task);
+    ESP_LOGD(TAG, "Request %s [%" PRIu32 ", %" PRIu32 "] handled in %" PRId64 " us", s_id, s_from_s, s_to_s,
+             esp_timer_get_time() - start);
+}
+
+void history_helper_on_published(int msg_id)
+{
+    if (!s_streaming)
+        return;
+
+    portENTER_CRITICAL(&s_ids_lock);
+    bool ours = take_id(s_in_flight, &s_in_flight_count, msg_id);
+    if (!ours)
+    {
+        // Possibly a chunk whose id is not recorded yet, otherwise another publish
+        s_unmatched[s_unmatched_next] = msg_id;
+        s_unmatched_next = (s_unmatched_next + 1) % HISTORY_WINDOW;
+    }
+    portEXIT_CRITICAL(&s_ids_lock);
+
+    // Never blocks the MQTT task: only ids taken from s_in_flight get here
+    if (ours && xQueueSend(s_acks, &msg_id, 0) != pdTRUE)
+        ESP_LOGE(TAG, "Acknowledgement %d dropped", msg_id);
+}
+
+#else
+
+void history_helper_init(void)
+{
+}
+
+void history_helper_add_sample(float temp, float hum)
+{
+}
+
+void history_helper_handle_command(const char *data, int len)
+{
+}
+
+void history_helper_on_published(int msg_id)
+{
+}
+
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+// Keeps the last hours of readings (history.h) and streams them over MQTT.
+// All functions are no-ops when the history is disabled in Kconfig.
+
+// Attaches the storage (restored after deep sleep when kept in RTC memory)
+// and starts the streaming task
+void history_helper_init(void);
+
+// Records a reading; one sample per history interval is kept
+void history_helper_add_sample(float temp, float hum);
+
+// Handles a request received on the history command topic, e.g.
+// {"id":"backfill-1","from":3600,"to":7200} (times on the device clock, both optional)
+void history_helper_handle_command(const char *data, int len);
+
+// Called for every MQTT_EVENT_PUBLISHED (acknowledged QoS 1 message)
+void history_helper_on_published(int msg_id);
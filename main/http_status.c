@@ -0,0 +1,122 @@
+#include "http_status.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "config.h"
+#include "device_state.h"
+#include "esp_log.h"
+
+#if HTTP_STATUS_ENABLE
+#include "esp_http_server.h"
+
+static const char *TAG = "HTTP";
+
+static httpd_handle_t s_server = NULL;
+
+// Response bodies, regenerated only when the device state version changes.
+// All handlers run in the single httpd task, so the cache needs no lock.
+static char s_metrics[1024];
+static int s_metrics_len = 0;
+static char s_state[320];
+static int s_state_len = 0;
+static uint32_t s_cached_version = 0;
+static bool s_cache_valid = false;
+
+static void refresh_cache(void)
+{
+    if (s_cache_valid && device_state_version() == s_cached_version)
+        return;
+
+    device_state_t st;
+    device_state_get(&st);
+
+    // Timestamps are uptime based, so the body only changes when the state does
+    s_metrics_len = snprintf(s_metrics, sizeof(s_metrics),
+                             "# TYPE esp32_sensor_temperature_celsius gauge\n"
+                             "esp32_sensor_temperature_celsius %.1f\n"
+                             "# TYPE esp32_sensor_humidity_percent gauge\n"
+                             "esp32_sensor_humidity_percent %.1f\n"
+                             "# TYPE esp32_sensor_sample_valid gauge\n"
+                             "esp32_sensor_sample_valid %d\n"
+                             "# TYPE esp32_sensor_sample_uptime_seconds gauge\n"
+                             "esp32_sensor_sample_uptime_seconds %" PRId64 "\n"
+                             "# TYPE esp32_sensor_last_publish_uptime_seconds gauge\n"
+                             "esp32_sensor_last_publish_uptime_seconds %" PRId64 "\n"
+                             "# TYPE esp32_sensor_wifi_connected gauge\n"
+                             "esp32_sensor_wifi_connected %d\n"
+                             "# TYPE esp32_sensor_mqtt_connected gauge\n"
+                             "esp32_sensor_mqtt_connected %d\n"
+                             "# TYPE esp32_sensor_display_enabled gauge\n"
+                             "esp32_sensor_display_enabled %d\n"
+                             "# TYPE esp32_sensor_state_version_total counter\n"
+                             "esp32_sensor_state_version_total %" PRIu32 "\n",
+                             st.temperature, st.humidity, st.sample_valid,
+                             st.sample_time_us / 1000000, st.last_send_time_us / 1000000,
+                             st.wifi_connected, st.mqtt_connected, st.display_enabled, st.version);
+
+    s_state_len = snprintf(s_state, sizeof(s_state),
+                           "{\"version\":%" PRIu32 ",\"wifi\":%s,\"mqtt\":%s,\"display\":%s,"
+                           "\"sample_valid\":%s,\"temperature\":%.1f,\"humidity\":%.1f,"
+                           "\"sample_uptime_ms\":%" PRId64 ",\"last_publish_uptime_ms\":%" PRId64 "}",
+                           st.version, st.wifi_connected ? "true" : "false", st.mqtt_connected ? "true" : "false",
+                           st.display_enabled ? "true" : "false", st.sample_valid ? "true" : "false",
+                           st.temperature, st.humidity, st.sample_time_us / 1000, st.last_send_time_us / 1000);
+
+    // snprintf reports the untruncated length
+    if (s_metrics_len >= (int)sizeof(s_metrics))
+        s_metrics_len = sizeof(s_metrics) - 1;
+    if (s_state_len >= (int)sizeof(s_state))
+        s_state_len = sizeof(s_state) - 1;
+
+    s_cached_version = st.version;
+    s_cache_valid = true;
+}
+
+static esp_err_t metrics_handler(httpd_req_t *req)
+{
+    refresh_cache();
+    httpd_resp_set_type(req, "text/plain; version=0.0.4");
+    return httpd_resp_send(req, s_metrics, s_metrics_len);
+}
+
+static esp_err_t state_handler(httpd_req_t *req)
+{
+    refresh_cache();
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, s_state, s_state_len);
+}
+
+void http_status_start(void)
+{
+    if (s_server)
+        return;
+
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = HTTP_STATUS_PORT;
+    config.max_open_sockets = HTTP_STATUS_MAX_SOCKETS;
+    // Drop the oldest idle connection instead of refusing a new scrape
+    config.lru_purge_enable = true;
+
+    if (httpd_start(&s_server, &config) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not start status server");
+        s_server = NULL;
+        return;
+    }
+
+    const httpd_uri_t metrics_uri = {.uri = "/metrics", .method = HTTP_GET, .handler = metrics_handler};
+    const httpd_uri_t state_uri = {.uri = "/state", .method = HTTP_GET, .handler = state_handler};
+    httpd_register_uri_handler(s_server, &metrics_uri);
+    httpd_register_uri_handler(s_server, &state_uri);
+
+    ESP_LOGI(TAG, "Status server on port %d", HTTP_STATUS_PORT);
+}
+
+#else
+
+void http_status_start(void)
+{
+}
+
+#endif
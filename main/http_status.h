@@ -0,0 +1,5 @@
+#pragma once
+
+// Starts the local status server (/metrics and /state) if enabled in Kconfig.
+// Safe to call repeatedly; only the first call starts the server.
+void http_status_start(void);
@@ -0,0 +1,130 @@
+#include "input.h"
+
+#include <stdint.h>
+
+#include "config.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mem_budget.h"
+
+static const char *TAG = "INPUT";
+
+#define INPUT_TASK_PRIORITY 5
+
+// Task notification bits: one edge and one timer bit per button
+#define EDGE_BIT(i) (1UL << (i))
+#define TIMER_BIT(i) (1UL << (16 + (i)))
+
+typedef struct
+{
+    input_button_t cfg;
+    esp_timer_handle_t timer; // one-shot, used for debounce and gesture timeouts
+    gesture_state_t state;
+} button_t;
+
+static button_t s_buttons[INPUT_MAX_BUTTONS];
+static int s_count = 0;
+static gesture_config_t s_gesture_cfg;
+static uint32_t s_debounce_ms = 0;
+static input_gesture_cb_t s_cb = NULL;
+static TaskHandle_t s_task = NULL;
+
+// Any edge wakes the task, which (re)starts the debounce timer
+static void IRAM_ATTR button_isr_handler(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(s_task, EDGE_BIT((int)(intptr_t)arg), eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static void button_timer_cb(void *arg)
+{
+    xTaskNotify(s_task, TIMER_BIT((int)(intptr_t)arg), eSetBits);
+}
+
+static void arm_timer(button_t *btn, uint32_t ms)
+{
+    esp_timer_stop(btn->timer); // not running is fine
+    esp_timer_start_once(btn->timer, (uint64_t)ms * 1000);
+}
+
+static void input_task(void *arg)
+{
+    while (1)
+    {
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+
+        for (int i = 0; i < s_count; i++)
+        {
+            button_t *btn = &s_buttons[i];
+
+            // Both bits can arrive in one notification: the expired timer is
+            // handled first, then the edge restarts the debounce
+            if (bits & TIMER_BIT(i))
+            {
+                bool pressed = gpio_get_level(btn->cfg.gpio) == btn->cfg.active_level;
+                uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+
+                gesture_result_t res = gesture_update(&btn->state, &s_gesture_cfg, pressed, now_ms);
+                if (res.timeout_ms)
+                    arm_timer(btn, res.timeout_ms);
+                if (res.gesture != GESTURE_NONE && s_cb)
+                    s_cb(i, res.gesture);
+            }
+
+            if (bits & EDGE_BIT(i))
+            {
+                // Level is sampled once it has been stable for the debounce time
+                arm_timer(btn, s_debounce_ms);
+            }
+        }
+    }
+}
+
+void input_init(const input_button_t *buttons, int count, const gesture_config_t *cfg, uint32_t debounce_ms,
+                input_gesture_cb_t cb)
+{
+    if (count > INPUT_MAX_BUTTONS)
+    {
+        ESP_LOGW(TAG, "Only %d buttons supported", INPUT_MAX_BUTTONS);
+        count = INPUT_MAX_BUTTONS;
+    }
+
+    s_count = count;
+    s_gesture_cfg = *cfg;
+    s_debounce_ms = debounce_ms;
+    s_cb = cb;
+
+    // Task must exist before the first interrupt can fire
+    s_task = APP_TASK_CREATE(input_task, "input_task", BUTTON_TASK_STACK_SIZE, INPUT_TASK_PRIORITY);
+
+    gpio_install_isr_service(0);
+
+    for (int i = 0; i < count; i++)
+    {
+        button_t *btn = &s_buttons[i];
+        btn->cfg = buttons[i];
+        btn->state = (gesture_state_t){0};
+
+        const esp_timer_create_args_t timer_args = {
+            .callback = &button_timer_cb,
+            .arg = (void *)(intptr_t)i,
+            .name = "button"};
+        ESP_ERROR_CHECK(esp_timer_create(&timer_args, &btn->timer));
+
+        gpio_config_t io_conf = {};
+        io_conf.intr_type = GPIO_INTR_ANYEDGE;
+        io_conf.mode = GPIO_MODE_INPUT;
+        io_conf.pin_bit_mask = (1ULL << btn->cfg.gpio);
+        io_conf.pull_down_en = (btn->cfg.active_level == 1);
+        io_conf.pull_up_en = (btn->cfg.active_level == 0);
+        gpio_config(&io_conf);
+
+        gpio_isr_handler_add(btn->cfg.gpio, button_isr_handler, (void *)(intptr_t)i);
+        ESP_LOGI(TAG, "Button %d on GPIO %d", i, btn->cfg.gpio);
+    }
+}
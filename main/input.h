@@ -0,0 +1,18 @@
+#pragma once
+#include "gesture.h"
+
+#define INPUT_MAX_BUTTONS 8
+
+typedef struct
+{
+    int gpio;
+    int active_level; // 0 = active LOW, 1 = active HIGH
+} input_button_t;
+
+// Called from the input task for every recognised gesture (index into the buttons array)
+typedef void (*input_gesture_cb_t)(int button, gesture_t gesture);
+
+// Configures the button GPIOs and starts the input task.
+// The task sleeps until a GPIO interrupt or a debounce/gesture timer wakes it.
+void input_init(const input_button_t *buttons, int count, const gesture_config_t *cfg, uint32_t debounce_ms,
+                input_gesture_cb_t cb);
@@ -1,8 +1,6 @@
-#include <math.h>
 #include <stdio.h>
 
 #include "config.h"
-#include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
@@ -11,12 +9,22 @@
 #include "wifi_provisioning/manager.h"
 
 // Modules
+#include "boot_trace.h"
+#include "device_state.h"
 #include "gui.h"
+#include "history_helper.h"
+#include "http_status.h"
+#include "input.h"
+#include "mem_budget.h"
 #include "mqtt_helper.h"
+#include "ota_helper.h"
+#include "publish_policy.h"
 #include "sensor.h"
+#include "tlog.h"
 #include "wifi_helper.h"
 
-static const char *TAG = "MAIN";
+#define TLOG_TAG "MAIN"
+static const char *TAG = TLOG_TAG;
 
 // Settings
 #define SEND_INTERVAL_HEARTBEAT_US CONFIG_SEND_INTERVAL_HEARTBEAT_US
@@ -24,114 +32,164 @@ static const char *TAG = "MAIN";
 #define THRESHOLD_HUM (CONFIG_THRESHOLD_HUM * 0.1f)
 #define BUTTON_GPIO CONFIG_BUTTON_GPIO
 #define BUTTON_ACTIVE_LEVEL CONFIG_BUTTON_ACTIVE_LEVEL
-#define LONG_PRESS_DURATION_MS 3000
+#define MEM_REPORT_INTERVAL_LOOPS 150 // ~5 minutes at 2 s per loop
+#define LOOP_INTERVAL_MS 2000
+#define SENSOR_MIN_INTERVAL_US 2000000 // DHT22 needs 2 s between reads
+#define BOOT_DISPLAY_TASK_PRIORITY 2
+#define BOOT_DISPLAY_TASK_STACK_SIZE 4096
+#define BOOT_SENSOR_WAIT_MS 100 // the display stage is slower than a read
 
-int64_t last_send_time = 0;
-volatile bool button_pressed = false;
 volatile bool provisioning_reset_triggered = false;
+volatile bool publish_requested = false;
 
-// Button interrupt handler
-static void IRAM_ATTR button_isr_handler(void *arg)
-{
-    button_pressed = true;
-}
+static const input_button_t buttons[] = {
+    {.gpio = BUTTON_GPIO, .active_level = BUTTON_ACTIVE_LEVEL},
+};
 
-// Dedicated task for button handling
-static void button_task(void *arg)
-{
-    while (1)
-    {
-        if (button_pressed)
-        {
-            button_pressed = false;
+static const publish_policy_t publish_policy = {
+    .threshold_temp = THRESHOLD_TEMP,
+    .threshold_hum = THRESHOLD_HUM,
+    .heartbeat_us = SEND_INTERVAL_HEARTBEAT_US,
+};
 
-            if (gpio_get_level(BUTTON_GPIO) == BUTTON_ACTIVE_LEVEL)
-            {
-                int64_t press_start = esp_timer_get_time();
-                bool is_long_press = false;
+static const gesture_config_t gesture_cfg = {
+    .long_press_ms = BUTTON_LONG_PRESS_MS,
+    .hold_ms = BUTTON_HOLD_MS,
+    .double_click_ms = BUTTON_DOUBLE_CLICK_MS,
+};
 
-                while (gpio_get_level(BUTTON_GPIO) == BUTTON_ACTIVE_LEVEL)
-                {
-                    vTaskDelay(pdMS_TO_TICKS(100));
-                    int64_t press_duration = (esp_timer_get_time() - press_start) / 1000;
+// Runs in the input task for every recognised gesture
+static void on_gesture(int button, gesture_t gesture)
+{
+    switch (gesture)
+    {
+    case GESTURE_SHORT_PRESS:
+        ESP_LOGI(TAG, "Short press - toggling display");
+        if (gui_is_enabled())
+            gui_turn_off();
+        else
+            gui_turn_on();
+        break;
 
-                    if (press_duration >= LONG_PRESS_DURATION_MS)
-                    {
-                        // Long press detected
-                        ESP_LOGI(TAG, "Long press detected - resetting WiFi provisioning");
+    case GESTURE_DOUBLE_CLICK:
+        ESP_LOGI(TAG, "Double click - publishing now");
+        publish_requested = true;
+        break;
 
-                        // Set status and block main loop
-                        gui_set_status("Resetting WiFi...");
-                        provisioning_reset_triggered = true;
+    case GESTURE_HOLD:
+        ESP_LOGI(TAG, "Hold detected - resetting WiFi provisioning");
 
-                        vTaskDelay(pdMS_TO_TICKS(500));
+        // Set status and block main loop
+        gui_set_status("Resetting WiFi...");
+        provisioning_reset_triggered = true;
 
-                        // This will erase WiFi credentials and restart the device
-                        wifi_helper_reset_provisioning();
+        vTaskDelay(pdMS_TO_TICKS(500));
 
-                        is_long_press = true;
-                        break;
-                    }
-                }
+        // This will erase WiFi credentials and restart the device
+        wifi_helper_reset_provisioning();
+        break;
 
-                // Short press - toggle display
-                if (!is_long_press)
-                {
-                    ESP_LOGI(TAG, "Short press - toggling display");
-                    if (gui_is_enabled())
-                        gui_turn_off();
-                    else
-                        gui_turn_on();
-                }
-            }
-        }
-        vTaskDelay(pdMS_TO_TICKS(50));
+    default:
+        ESP_LOGD(TAG, "Gesture %d on button %d not bound", gesture, button);
+        break;
     }
 }
 
-void app_main(void)
+// Boot stage: I2C, panel reset and LVGL, in parallel with NVS and Wi-Fi start
+static void boot_display_task(void *arg)
 {
-    // --- 1. Hardware init ---
-    gpio_config_t io_conf = {};
-    io_conf.intr_type = (BUTTON_ACTIVE_LEVEL == 0) ? GPIO_INTR_NEGEDGE : GPIO_INTR_POSEDGE;
-    io_conf.mode = GPIO_MODE_INPUT;
-    io_conf.pin_bit_mask = (1ULL << BUTTON_GPIO);
-    io_conf.pull_down_en = 0;
-    io_conf.pull_up_en = 1;
-    gpio_config(&io_conf);
-
-    gpio_install_isr_service(0);
-    gpio_isr_handler_add(BUTTON_GPIO, button_isr_handler, NULL);
+    // Registered here, so the entry cannot outlive the task
+    mem_budget_register_task(xTaskGetCurrentTaskHandle(), BOOT_DISPLAY_TASK_STACK_SIZE);
 
     gui_init();
     gui_set_status("Booting...");
+    boot_trace_mark(BOOT_STAGE_DISPLAY);
 
-    // --- 3. Init modules ---
-    wifi_helper_init();
-    sensor_init();
+    // Show the early reading as soon as the panel is up
+    device_state_t state;
+    boot_trace_wait(BOOT_BIT(BOOT_STAGE_SENSOR), pdMS_TO_TICKS(BOOT_SENSOR_WAIT_MS));
+    device_state_get(&state);
+    if (state.sample_valid)
+    {
+        gui_set_values(state.temperature, state.humidity);
+        boot_trace_mark(BOOT_STAGE_FIRST_VALUE);
+    }
+
+    mem_budget_unregister_task(xTaskGetCurrentTaskHandle());
+    vTaskDelete(NULL);
+}
 
-    xTaskCreate(button_task, "button_task", 4096, NULL, 5, NULL);
-    ESP_LOGI(TAG, "Button task started");
+void app_main(void)
+{
+    // Stage timestamps and dependencies, then the tokenised log ring, so nothing is lost
+    boot_trace_init();
+    tlog_init();
 
+    // Arms the rollback deadline if this is the first boot after an update
+    ota_helper_init();
+    history_helper_init();
+
+    // --- 1. Display (own task) ---
+    // Not APP_TASK_CREATE: the task ends after boot, and only a heap stack is
+    // freed then. A static one would stay reserved in the static profile.
+    if (xTaskCreate(boot_display_task, "boot_gui", BOOT_DISPLAY_TASK_STACK_SIZE, NULL, BOOT_DISPLAY_TASK_PRIORITY,
+                    NULL) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not start display task, initialising in line");
+        gui_init();
+        gui_set_status("Booting...");
+        boot_trace_mark(BOOT_STAGE_DISPLAY);
+    }
+
+    // --- 2. First reading, before the network is up ---
+    sensor_init();
     float current_temp = 0.0;
     float current_hum = 0.0;
-    float last_sent_temp = -127.0;
-    float last_sent_hum = -1.0;
+    int64_t last_read_us = esp_timer_get_time();
+    if (sensor_read_values(&current_temp, &current_hum))
+    {
+        device_state_set_sample(current_temp, current_hum, last_read_us);
+        history_helper_add_sample(current_temp, current_hum);
+    }
+    else
+        device_state_set_sample_error();
+    boot_trace_mark(BOOT_STAGE_SENSOR);
+
+    // --- 3. Network (NVS, netif, provisioning or STA start) ---
+    wifi_helper_init();
+
+    // Gestures drive the display, so wait for it
+    boot_trace_wait(BOOT_BIT(BOOT_STAGE_DISPLAY), portMAX_DELAY);
+    input_init(buttons, sizeof(buttons) / sizeof(buttons[0]), &gesture_cfg, BUTTON_DEBOUNCE_MS, on_gesture);
+    ESP_LOGI(TAG, "Input task started");
+
+    mem_budget_register_task(xTaskGetCurrentTaskHandle(), CONFIG_ESP_MAIN_TASK_STACK_SIZE);
+    int loop_count = 0;
+
+    publish_record_t last_sent = {.temp = -127.0, .hum = -1.0, .time_us = 0};
 
     bool mqtt_started = false;
 
     while (1)
     {
-        // Read and display sensor values
-        if (sensor_read_values(&current_temp, &current_hum))
-        {
-            gui_set_values(current_temp, current_hum);
-        }
-        else
+        // Read and display sensor values (the loop may wake early during boot)
+        if (esp_timer_get_time() - last_read_us >= SENSOR_MIN_INTERVAL_US)
         {
-            if (!provisioning_reset_triggered && wifi_helper_is_connected())
+            last_read_us = esp_timer_get_time();
+            if (sensor_read_values(&current_temp, &current_hum))
             {
-                gui_set_status("Sensor Error");
+                device_state_set_sample(current_temp, current_hum, last_read_us);
+                history_helper_add_sample(current_temp, current_hum);
+                gui_set_values(current_temp, current_hum);
+                boot_trace_mark(BOOT_STAGE_FIRST_VALUE);
+            }
+            else
+            {
+                device_state_set_sample_error();
+                if (!provisioning_reset_triggered && wifi_helper_is_connected())
+                {
+                    gui_set_status("Sensor Error");
+                }
             }
         }
 
@@ -144,27 +202,35 @@ void app_main(void)
                 {
                     ESP_LOGI(TAG, "WiFi ready, starting MQTT...");
                     mqtt_helper_start();
+                    http_status_start();
                     mqtt_started = true;
                 }
 
+                // Firmware update in progress -> keep the link free
+                if (ota_helper_is_running())
+                {
+                    gui_set_status("Updating...");
+                }
                 // MQWTT connected -> send data if needed
-                if (mqtt_helper_is_connected())
+                else if (mqtt_helper_is_connected())
                 {
-                    bool diff_temp = fabs(current_temp - last_sent_temp) >= THRESHOLD_TEMP;
-                    bool diff_hum = fabs(current_hum - last_sent_hum) >= THRESHOLD_HUM;
                     int64_t now = esp_timer_get_time();
-                    bool heartbeat = (now - last_send_time) > SEND_INTERVAL_HEARTBEAT_US;
 
-                    if (diff_temp || diff_hum || heartbeat)
+                    if (publish_policy_due(&publish_policy, &last_sent, current_temp, current_hum, now) ||
+                        publish_requested)
                     {
+                        publish_requested = false;
                         gui_set_status("Sending MQTT...");
                         mqtt_helper_send_data(current_temp, current_hum);
 
-                        last_sent_temp = current_temp;
-                        last_sent_hum = current_hum;
-                        last_send_time = now;
+                        last_sent = (publish_record_t){.temp = current_temp, .hum = current_hum, .time_us = now};
+                        device_state_set_last_send(now);
 
-                        ESP_LOGI(TAG, "Update sent. T:%.1f H:%.1f", current_temp, current_hum);
+                        TLOGI(TLOG_TAG, "Update sent. T:%.1f H:%.1f", current_temp, current_hum);
+
+                        // Timeline of this boot, once, right after the first state message
+                        if (boot_trace_mark(BOOT_STAGE_FIRST_PUBLISH))
+                            mqtt_helper_send_boot_trace();
                     }
                     else
                     {
@@ -193,7 +259,15 @@ void app_main(void)
             }
         }
 
-        // Delay before next iteration
-        vTaskDelay(pdMS_TO_TICKS(2000));
+        // Stack watermarks and heap state for sizing the static profile
+        if (++loop_count % MEM_REPORT_INTERVAL_LOOPS == 1)
+            mem_budget_log();
+
+        // Delay before next iteration, cut short when the link comes up during boot
+        uint32_t link = boot_trace_pending(BOOT_BIT(BOOT_STAGE_WIFI_CONNECTED) | BOOT_BIT(BOOT_STAGE_MQTT_CONNECTED));
+        if (link && !provisioning_reset_triggered)
+            boot_trace_wait_any(link, pdMS_TO_TICKS(LOOP_INTERVAL_MS));
+        else
+            vTaskDelay(pdMS_TO_TICKS(LOOP_INTERVAL_MS));
     }
 }
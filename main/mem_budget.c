@@ -0,0 +1,80 @@
+#include "mem_budget.h"
+
+#include <inttypes.h>
+
+#include "config.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_system.h"
+
+static const char *TAG = "MEM";
+
+#define MAX_TASKS 8
+
+typedef struct
+{
+    TaskHandle_t handle;
+    uint32_t stack_size;
+} task_entry_t;
+
+static task_entry_t s_tasks[MAX_TASKS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+TaskHandle_t mem_budget_register_task(TaskHandle_t handle, uint32_t stack_size)
+{
+    if (!handle)
+    {
+        ESP_LOGE(TAG, "Task creation failed (stack %" PRIu32 " bytes)", stack_size);
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < MAX_TASKS; i++)
+    {
+        if (s_tasks[i].handle == NULL)
+        {
+            s_tasks[i].handle = handle;
+            s_tasks[i].stack_size = stack_size;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return handle;
+}
+
+void mem_budget_unregister_task(TaskHandle_t handle)
+{
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < MAX_TASKS; i++)
+    {
+        if (s_tasks[i].handle == handle)
+            s_tasks[i].handle = NULL;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void mem_budget_log(void)
+{
+    // Info level, so the report does not depend on CONFIG_LOG_MAXIMUM_LEVEL
+    if (!MEM_BUDGET_LOG)
+        return;
+
+    for (int i = 0; i < MAX_TASKS; i++)
+    {
+        // Copy under the lock, a task may unregister concurrently
+        portENTER_CRITICAL(&s_lock);
+        task_entry_t entry = s_tasks[i];
+        portEXIT_CRITICAL(&s_lock);
+
+        if (!entry.handle)
+            continue;
+
+        uint32_t free_min = uxTaskGetStackHighWaterMark(entry.handle);
+        ESP_LOGI(TAG, "Task %-12s stack %5" PRIu32 " used %5" PRIu32 " free %5" PRIu32,
+                 pcTaskGetName(entry.handle), entry.stack_size, entry.stack_size - free_min, free_min);
+    }
+
+    ESP_LOGI(TAG, "Heap free %" PRIu32 " min %" PRIu32 " largest block %u",
+             esp_get_free_heap_size(), esp_get_minimum_free_heap_size(),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+// Creates an application task and registers it for watermark logging.
+// Evaluates to the task handle, or NULL on failure.
+// With CONFIG_STATIC_MEMORY the stack and TCB live in a static arena named after
+// the task function, so they show up per module in the mem_budget report.
+// Note: ESP-IDF stack sizes are in bytes (StackType_t is uint8_t).
+#if CONFIG_STATIC_MEMORY
+#define APP_TASK_CREATE(fn, name, stack_size, prio)                                                    \
+    ({                                                                                                 \
+        static StackType_t fn##_stack[stack_size];                                                     \
+        static StaticTask_t fn##_tcb;                                                                  \
+        mem_budget_register_task(xTaskCreateStatic(fn, name, stack_size, NULL, prio, fn##_stack, &fn##_tcb), \
+                                 stack_size);                                                          \
+    })
+#else
+#define APP_TASK_CREATE(fn, name, stack_size, prio)                   \
+    ({                                                                \
+        TaskHandle_t _handle = NULL;                                  \
+        xTaskCreate(fn, name, stack_size, NULL, prio, &_handle);      \
+        mem_budget_register_task(_handle, stack_size);                \
+    })
+#endif
+
+// Remembers a task for mem_budget_log(). Returns the handle (NULL if task creation failed).
+TaskHandle_t mem_budget_register_task(TaskHandle_t handle, uint32_t stack_size);
+
+// Forgets a task (call before it deletes itself)
+void mem_budget_unregister_task(TaskHandle_t handle);
+
+// Logs stack high-water marks of all registered tasks and heap statistics
+// (info level, only with CONFIG_MEM_BUDGET_LOG)
+void mem_budget_log(void);
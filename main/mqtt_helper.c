@@ -1,16 +1,28 @@
 #include "mqtt_helper.h"
 
+#include <math.h>
 #include <stdio.h>
 
-#include "cJSON.h"
+#include <string.h>
+
+#include "boot_trace.h"
+#include "comfort.h"
 #include "config.h"
+#include "device_state.h"
 #include "esp_log.h"
 #include "esp_mac.h"
+#include "history_helper.h"
 #include "mqtt_client.h"
+#include "mqtt_payload.h"
+#include "mqtt_tls.h"
+#include "ota_helper.h"
+#include "tlog.h"
+
+#define TLOG_TAG "MQTT"
+static const char *TAG = TLOG_TAG;
 
-static const char *TAG = "MQTT";
+#define DISCOVERY_PAYLOAD_SIZE 512
 static esp_mqtt_client_handle_t client = NULL;
-static bool s_mqtt_connected = false;
 
 // Dynamic identifiers so multiple devices can coexist in Home Assistant
 static bool ids_ready = false;
@@ -21,7 +33,17 @@ static char topic_conf_temp[96];
 static char topic_conf_hum[96];
 static char uniq_id_temp[48];
 static char uniq_id_hum[48];
+static char topic_conf_dew[96];
+static char topic_conf_ah[96];
+static char topic_conf_hi[96];
+static char uniq_id_dew[48];
+static char uniq_id_ah[48];
+static char uniq_id_hi[48];
 static char topic_lwt[96];
+static char topic_cmd_ota[96];
+static char topic_boot[96];
+static char topic_cmd_history[96];
+static char topic_history[96];
 
 static void init_identifiers(void)
 {
@@ -47,10 +69,20 @@ static void init_identifiers(void)
     snprintf(topic_state, sizeof(topic_state), "homeassistant/sensor/%s/state", device_id);
     snprintf(topic_conf_temp, sizeof(topic_conf_temp), "homeassistant/sensor/%s_temp/config", device_id);
     snprintf(topic_conf_hum, sizeof(topic_conf_hum), "homeassistant/sensor/%s_hum/config", device_id);
+    snprintf(topic_conf_dew, sizeof(topic_conf_dew), "homeassistant/sensor/%s_dew/config", device_id);
+    snprintf(topic_conf_ah, sizeof(topic_conf_ah), "homeassistant/sensor/%s_ah/config", device_id);
+    snprintf(topic_conf_hi, sizeof(topic_conf_hi), "homeassistant/sensor/%s_hi/config", device_id);
     snprintf(topic_lwt, sizeof(topic_lwt), "homeassistant/sensor/%s/availability", device_id);
+    snprintf(topic_cmd_ota, sizeof(topic_cmd_ota), "homeassistant/sensor/%s/cmd/ota", device_id);
+    snprintf(topic_boot, sizeof(topic_boot), "homeassistant/sensor/%s/boot", device_id);
+    snprintf(topic_cmd_history, sizeof(topic_cmd_history), "homeassistant/sensor/%s/cmd/history", device_id);
+    snprintf(topic_history, sizeof(topic_history), "homeassistant/sensor/%s/history", device_id);
 
     snprintf(uniq_id_temp, sizeof(uniq_id_temp), "%s-temp", device_id);
     snprintf(uniq_id_hum, sizeof(uniq_id_hum), "%s-hum", device_id);
+    snprintf(uniq_id_dew, sizeof(uniq_id_dew), "%s-dew", device_id);
+    snprintf(uniq_id_ah, sizeof(uniq_id_ah), "%s-ah", device_id);
+    snprintf(uniq_id_hi, sizeof(uniq_id_hi), "%s-hi", device_id);
 
     ids_ready = true;
 }
@@ -59,20 +91,47 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
 {
     (void)handler_args; // Unused
     (void)base;         // Unused
-    (void)event_data;   // Unused
+    esp_mqtt_event_handle_t event = event_data;
 
     switch ((esp_mqtt_event_id_t)event_id)
     {
     case MQTT_EVENT_CONNECTED:
         ESP_LOGI(TAG, "MQTT Connected");
-        s_mqtt_connected = true;
+        device_state_set_mqtt_connected(true);
+        boot_trace_mark(BOOT_STAGE_MQTT_CONNECTED);
+        // Reaching the broker is the health check for a freshly updated image
+        ota_helper_mark_healthy();
         // Publish online status and send discovery payloads
         esp_mqtt_client_publish(client, topic_lwt, "online", 6, 1, 1);
+        esp_mqtt_client_subscribe(client, topic_cmd_ota, 1);
+#if HISTORY_ENABLE
+        esp_mqtt_client_subscribe(client, topic_cmd_history, 1);
+#endif
         mqtt_helper_send_discovery();
         break;
+    case MQTT_EVENT_DATA:
+        // Commands are small, fragmented messages are ignored
+        if (event->data_len != event->total_data_len)
+            break;
+        if (event->topic_len == (int)strlen(topic_cmd_ota) &&
+            strncmp(event->topic, topic_cmd_ota, event->topic_len) == 0)
+        {
+            ESP_LOGI(TAG, "OTA command received");
+            ota_helper_handle_command(event->data, event->data_len);
+        }
+        else if (event->topic_len == (int)strlen(topic_cmd_history) &&
+                 strncmp(event->topic, topic_cmd_history, event->topic_len) == 0)
+        {
+            ESP_LOGI(TAG, "History request received");
+            history_helper_handle_command(event->data, event->data_len);
+        }
+        break;
+    case MQTT_EVENT_PUBLISHED:
+        history_helper_on_published(event->msg_id);
+        break;
     case MQTT_EVENT_DISCONNECTED:
         ESP_LOGI(TAG, "MQTT Disconnected");
-        s_mqtt_connected = false;
+        device_state_set_mqtt_connected(false);
         break;
     default:
         break;
@@ -96,88 +155,166 @@ void mqtt_helper_start(void)
         .session.last_will.msg_len = 7,
         .session.last_will.qos = 1,
         .session.last_will.retain = true,
+        .buffer.size = MQTT_BUFFER_SIZE,
+        .outbox.limit = MQTT_OUTBOX_LIMIT,
     };
 
+    // NULL unless TLS is enabled; the client then derives the transport from the URI
+    mqtt_cfg.network.transport = mqtt_tls_transport_create();
+
     client = esp_mqtt_client_init(&mqtt_cfg);
     esp_mqtt_client_register_event(client, ESP_EVENT_ANY_ID, mqtt_event_handler, client);
     esp_mqtt_client_start(client);
 }
 
+// Publishes one discovery payload (built into the shared static buffer)
+static void publish_discovery(char *buf, size_t size, const char *topic, const mqtt_discovery_t *d)
+{
+    int len = mqtt_payload_discovery(buf, size, d);
+    if (!len)
+    {
+        ESP_LOGE(TAG, "Discovery payload for %s truncated", d->uniq_id);
+        return;
+    }
+    esp_mqtt_client_publish(client, topic, buf, len, 1, 1);
+}
+
 void mqtt_helper_send_discovery(void)
 {
-    if (!client || !s_mqtt_connected)
+    if (!client || !mqtt_helper_is_connected())
         return;
 
     init_identifiers();
 
-    // Temperature config
-    cJSON *root_t = cJSON_CreateObject();
-    cJSON_AddStringToObject(root_t, "name", SENSOR_NAME_TEMP);
-    cJSON_AddStringToObject(root_t, "dev_cla", "temperature");
-    cJSON_AddStringToObject(root_t, "stat_cla", "measurement");
-    cJSON_AddStringToObject(root_t, "unit_of_meas", "°C");
-    cJSON_AddStringToObject(root_t, "stat_t", topic_state);
-    cJSON_AddStringToObject(root_t, "val_tpl", "{{ value_json.temperature }}");
-    cJSON_AddStringToObject(root_t, "uniq_id", uniq_id_temp);
-
-    cJSON_AddStringToObject(root_t, "avty_t", topic_lwt);       // availability_topic
-    cJSON_AddStringToObject(root_t, "pl_avail", "online");      // payload_available
-    cJSON_AddStringToObject(root_t, "pl_not_avail", "offline"); // payload_not_available
-
-    cJSON *dev = cJSON_CreateObject();
-    cJSON_AddStringToObject(dev, "ids", device_id);
-    cJSON_AddStringToObject(dev, "name", device_name);
-    cJSON_AddStringToObject(dev, "mf", "Espressif");
-    cJSON_AddItemToObject(root_t, "dev", dev);
-
-    char *json_str_t = cJSON_PrintUnformatted(root_t);
-    esp_mqtt_client_publish(client, topic_conf_temp, json_str_t, 0, 1, 1);
-    cJSON_Delete(root_t);
-    free(json_str_t);
+    // Only called from the MQTT task, so one static buffer is enough
+    static char payload[DISCOVERY_PAYLOAD_SIZE];
+
+    // Temperature config (carries the full device block)
+    const mqtt_discovery_t temp = {
+        .name = SENSOR_NAME_TEMP,
+        .dev_cla = "temperature",
+        .unit = "°C",
+        .val_tpl = "{{ value_json.temperature }}",
+        .uniq_id = uniq_id_temp,
+        .stat_t = topic_state,
+        .avty_t = topic_lwt,
+        .dev_ids = device_id,
+        .dev_name = device_name,
+    };
+    publish_discovery(payload, sizeof(payload), topic_conf_temp, &temp);
 
     // Humidity config
-    cJSON *root_h = cJSON_CreateObject();
-    cJSON_AddStringToObject(root_h, "name", SENSOR_NAME_HUM);
-    cJSON_AddStringToObject(root_h, "dev_cla", "humidity");
-    cJSON_AddStringToObject(root_h, "stat_cla", "measurement");
-    cJSON_AddStringToObject(root_h, "unit_of_meas", "%");
-    cJSON_AddStringToObject(root_h, "stat_t", topic_state);
-    cJSON_AddStringToObject(root_h, "val_tpl", "{{ value_json.humidity }}");
-    cJSON_AddStringToObject(root_h, "uniq_id", uniq_id_hum);
-
-    cJSON_AddStringToObject(root_h, "avty_t", topic_lwt);
-    cJSON_AddStringToObject(root_h, "pl_avail", "online");
-    cJSON_AddStringToObject(root_h, "pl_not_avail", "offline");
-
-    cJSON *dev2 = cJSON_CreateObject();
-    cJSON_AddStringToObject(dev2, "ids", device_id);
-    cJSON_AddItemToObject(root_h, "dev", dev2);
-
-    char *json_str_h = cJSON_PrintUnformatted(root_h);
-    esp_mqtt_client_publish(client, topic_conf_hum, json_str_h, 0, 1, 1);
-    cJSON_Delete(root_h);
-    free(json_str_h);
+    const mqtt_discovery_t hum = {
+        .name = SENSOR_NAME_HUM,
+        .dev_cla = "humidity",
+        .unit = "%",
+        .val_tpl = "{{ value_json.humidity }}",
+        .uniq_id = uniq_id_hum,
+        .stat_t = topic_state,
+        .avty_t = topic_lwt,
+        .dev_ids = device_id,
+    };
+    publish_discovery(payload, sizeof(payload), topic_conf_hum, &hum);
+
+#if COMFORT_METRICS
+    // Derived comfort metrics share the state topic
+    const mqtt_discovery_t dew = {
+        .name = "Dew Point",
+        .dev_cla = "temperature",
+        .unit = "°C",
+        .val_tpl = "{{ value_json.dew_point }}",
+        .uniq_id = uniq_id_dew,
+        .stat_t = topic_state,
+        .avty_t = topic_lwt,
+        .dev_ids = device_id,
+    };
+    publish_discovery(payload, sizeof(payload), topic_conf_dew, &dew);
+
+    // Home Assistant has no device class for absolute humidity
+    const mqtt_discovery_t ah = {
+        .name = "Absolute Humidity",
+        .unit = "g/m³",
+        .val_tpl = "{{ value_json.abs_humidity }}",
+        .uniq_id = uniq_id_ah,
+        .stat_t = topic_state,
+        .avty_t = topic_lwt,
+        .dev_ids = device_id,
+    };
+    publish_discovery(payload, sizeof(payload), topic_conf_ah, &ah);
+
+    const mqtt_discovery_t hi = {
+        .name = "Heat Index",
+        .dev_cla = "temperature",
+        .unit = "°C",
+        .val_tpl = "{{ value_json.heat_index }}",
+        .uniq_id = uniq_id_hi,
+        .stat_t = topic_state,
+        .avty_t = topic_lwt,
+        .dev_ids = device_id,
+    };
+    publish_discovery(payload, sizeof(payload), topic_conf_hi, &hi);
+#endif
 
     ESP_LOGI(TAG, "Discovery sent!");
 }
 
 void mqtt_helper_send_data(float temp, float hum)
 {
-    if (!client || !s_mqtt_connected)
+    if (!client || !mqtt_helper_is_connected())
         return;
 
-    // Build JSON manually for predictable rounding (%.1f)
-    char json_str[64];
+    const comfort_t *metrics = NULL;
+#if COMFORT_METRICS
+    // Same 0.1 resolution as the published values
+    comfort_t comfort;
+    comfort_compute(lroundf(temp * 10.0f), lroundf(hum * 10.0f), &comfort);
+    metrics = &comfort;
+#endif
 
-    // %.1f enforces exactly one decimal place
-    snprintf(json_str, sizeof(json_str), "{\"temperature\":%.1f,\"humidity\":%.1f}", temp, hum);
+    // Build JSON manually for predictable rounding (%.1f)
+    char json_str[128];
+    int len = mqtt_payload_state(json_str, sizeof(json_str), temp, hum, metrics);
+    if (!len)
+    {
+        TLOGE(TLOG_TAG, "State payload truncated");
+        return;
+    }
 
     // Publish data
-    esp_mqtt_client_publish(client, topic_state, json_str, 0, 1, 0);
-    ESP_LOGI(TAG, "Sent data: %s", json_str);
+    esp_mqtt_client_publish(client, topic_state, json_str, len, 1, 0);
+    TLOGI(TLOG_TAG, "Sent state (%d bytes)", len);
+}
+
+void mqtt_helper_send_boot_trace(void)
+{
+    if (!client || !mqtt_helper_is_connected())
+        return;
+
+    char json_str[256];
+    int len = boot_trace_json(json_str, sizeof(json_str));
+    if (!len)
+    {
+        ESP_LOGE(TAG, "Boot timeline truncated");
+        return;
+    }
+
+    // Retained, so it can be read after the fact
+    esp_mqtt_client_publish(client, topic_boot, json_str, len, 1, 1);
+    ESP_LOGI(TAG, "Boot timeline sent: %s", json_str);
+}
+
+int mqtt_helper_publish_history(const char *data, int len)
+{
+    if (!client || !mqtt_helper_is_connected())
+        return -1;
+
+    // QoS 1, so the streaming task gets MQTT_EVENT_PUBLISHED per chunk for flow control
+    return esp_mqtt_client_publish(client, topic_history, data, len, 1, 0);
 }
 
 bool mqtt_helper_is_connected(void)
 {
-    return s_mqtt_connected;
+    device_state_t state;
+    device_state_get(&state);
+    return state.mqtt_connected;
 }
@@ -10,5 +10,11 @@ void mqtt_helper_send_discovery(void);
 // Sends current measurement values
 void mqtt_helper_send_data(float temp, float hum);
 
+// Sends the boot timeline (boot_trace.h) as a retained message
+void mqtt_helper_send_boot_trace(void);
+
+// Publishes one history chunk (QoS 1). Returns the message id, or -1 when not connected.
+int mqtt_helper_publish_history(const char *data, int len);
+
 // Returns true when connected to the broker
 bool mqtt_helper_is_connected(void);
@@ -0,0 +1,94 @@
+#include "mqtt_payload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Appends formatted text at *len; once anything overflowed *len stays out of range
+#define APPEND(buf, size, len, ...)                                          \
+    do                                                                       \
+    {                                                                        \
+        if ((len) >= 0 && (len) < (int)(size))                               \
+            (len) += snprintf((buf) + (len), (size) - (len), __VA_ARGS__);   \
+    } while (0)
+
+// Tenths as "-1.5"; integer only, no float formatting
+#define TENTHS_FMT "%s%d.%d"
+#define TENTHS_ARGS(v) ((v) < 0 ? "-" : ""), abs(v) / 10, abs(v) % 10
+
+// Appends "key":"value" with the value escaped as a JSON string (names come from Kconfig)
+static void append_member(char *buf, size_t size, int *len, const char *key, const char *value)
+{
+    APPEND(buf, size, *len, "\"%s\":\"", key);
+    for (const unsigned char *p = (const unsigned char *)value; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            APPEND(buf, size, *len, "\\%c", *p);
+        else if (*p < 0x20)
+            APPEND(buf, size, *len, "\\u%04x", *p);
+        else if (*len >= 0 && *len < (int)size - 1)
+            buf[(*len)++] = *p;
+        else
+            *len = size; // overflow
+    }
+    APPEND(buf, size, *len, "\"");
+}
+
+int mqtt_payload_discovery(char *buf, size_t size, const mqtt_discovery_t *d)
+{
+    int len = 0;
+
+    APPEND(buf, size, len, "{");
+    append_member(buf, size, &len, "name", d->name);
+    if (d->dev_cla)
+    {
+        APPEND(buf, size, len, ",");
+        append_member(buf, size, &len, "dev_cla", d->dev_cla);
+    }
+    APPEND(buf, size, len, ",\"stat_cla\":\"measurement\",");
+    append_member(buf, size, &len, "unit_of_meas", d->unit);
+    APPEND(buf, size, len, ",");
+    append_member(buf, size, &len, "stat_t", d->stat_t);
+    APPEND(buf, size, len, ",");
+    append_member(buf, size, &len, "val_tpl", d->val_tpl);
+    APPEND(buf, size, len, ",");
+    append_member(buf, size, &len, "uniq_id", d->uniq_id);
+    APPEND(buf, size, len, ",");
+    append_member(buf, size, &len, "avty_t", d->avty_t);
+    // availability
+    APPEND(buf, size, len, ",\"pl_avail\":\"online\",\"pl_not_avail\":\"offline\",\"dev\":{");
+    append_member(buf, size, &len, "ids", d->dev_ids);
+    if (d->dev_name)
+    {
+        APPEND(buf, size, len, ",");
+        append_member(buf, size, &len, "name", d->dev_name);
+        APPEND(buf, size, len, ",\"mf\":\"Espressif\"");
+    }
+    APPEND(buf, size, len, "}}");
+
+    if (len <= 0 || len >= (int)size)
+        return 0;
+    return len;
+}
+
+int mqtt_payload_state(char *buf, size_t size, float temp, float hum, const comfort_t *comfort)
+{
+    // %.1f enforces exactly one decimal place
+    int len = snprintf(buf, size, "{\"temperature\":%.1f,\"humidity\":%.1f", temp, hum);
+
+    if (comfort)
+    {
+        int ah = comfort->abs_humidity_g100;
+        APPEND(buf, size, len, ",\"dew_point\":" TENTHS_FMT ",\"abs_humidity\":%d.%02d",
+               TENTHS_ARGS(comfort->dew_point_c10), ah / 100, ah % 100);
+        // null makes the Home Assistant sensor unknown instead of showing a wrong value
+        if (comfort->heat_index_c10 == COMFORT_HI_NONE)
+            APPEND(buf, size, len, ",\"heat_index\":null");
+        else
+            APPEND(buf, size, len, ",\"heat_index\":" TENTHS_FMT, TENTHS_ARGS(comfort->heat_index_c10));
+    }
+    APPEND(buf, size, len, "}");
+
+    if (len <= 0 || len >= (int)size)
+        return 0;
+    return len;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+
+#include "comfort.h"
+
+// MQTT payload builders used by mqtt_helper.c.
+// Plain snprintf into caller buffers: no heap, no ESP-IDF dependencies (host benchmarks).
+
+typedef struct
+{
+    const char *name;     // friendly entity name
+    const char *dev_cla;  // Home Assistant device class (NULL to omit)
+    const char *unit;     // unit of measurement
+    const char *val_tpl;  // value template into the state JSON
+    const char *uniq_id;  // unique entity id
+    const char *stat_t;   // state topic
+    const char *avty_t;   // availability topic
+    const char *dev_ids;  // device identifier
+    const char *dev_name; // NULL to reference the device by id only
+} mqtt_discovery_t;
+
+// Builds one Home Assistant discovery payload.
+// Returns the length, or 0 if it did not fit into buf.
+int mqtt_payload_discovery(char *buf, size_t size, const mqtt_discovery_t *d);
+
+// Builds the state payload {"temperature":21.5,"humidity":45.0}, extended by
+// dew_point, abs_humidity and heat_index when comfort is not NULL (heat_index
+// is null outside 20..50 °C).
+// Returns the length, or 0 if it did not fit into buf.
+int mqtt_payload_state(char *buf, size_t size, float temp, float hum, const comfort_t *comfort);
@@ -0,0 +1,203 @@
+#include "mqtt_tls.h"
+
+#include "config.h"
+
+#if MQTT_TLS_ENABLE
+#include <inttypes.h>
+#include <string.h>
+#include <sys/select.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_tls.h"
+
+static const char *TAG = "MQTT_TLS";
+
+#define MQTT_TLS_DEFAULT_PORT 8883
+
+// Embedded by main/CMakeLists.txt (EMBED_TXTFILES, NUL-terminated)
+extern const char mqtt_ca_pem_start[] asm("_binary_mqtt_ca_pem_start");
+extern const char mqtt_ca_pem_end[] asm("_binary_mqtt_ca_pem_end");
+
+// One client, one connection at a time, all calls from the MQTT task
+static esp_tls_t *s_tls = NULL;
+#if MQTT_TLS_SESSION_RESUMPTION
+// Outlives the connection so the next handshake can be abbreviated
+static esp_tls_client_session_t *s_session = NULL;
+
+static void drop_session(void)
+{
+    if (s_session)
+    {
+        esp_tls_free_client_session(s_session);
+        s_session = NULL;
+    }
+}
+#endif
+
+// ---------------- SOCKET POLLING ----------------
+
+// Returns >0 when ready, 0 on timeout, -1 on error (same contract as transport_ssl)
+static int tls_poll(int timeout_ms, bool write)
+{
+    int fd = -1;
+    if (!s_tls || esp_tls_get_conn_sockfd(s_tls, &fd) != ESP_OK || fd < 0)
+        return -1;
+
+    fd_set ready, errset;
+    FD_ZERO(&ready);
+    FD_ZERO(&errset);
+    FD_SET(fd, &ready);
+    FD_SET(fd, &errset);
+
+    struct timeval timeout = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int ret = select(fd + 1, write ? NULL : &ready, write ? &ready : NULL, &errset, timeout_ms < 0 ? NULL : &timeout);
+    if (ret > 0 && FD_ISSET(fd, &errset))
+        return -1;
+    return ret;
+}
+
+static int tls_poll_read(esp_transport_handle_t t, int timeout_ms)
+{
+    // Decrypted bytes may already wait inside mbedTLS without the socket being readable
+    if (s_tls && esp_tls_get_bytes_avail(s_tls) > 0)
+        return 1;
+    return tls_poll(timeout_ms, false);
+}
+
+static int tls_poll_write(esp_transport_handle_t t, int timeout_ms)
+{
+    return tls_poll(timeout_ms, true);
+}
+
+// ---------------- CONNECTION ----------------
+
+static int tls_close(esp_transport_handle_t t)
+{
+    if (s_tls)
+    {
+        esp_tls_conn_destroy(s_tls);
+        s_tls = NULL;
+    }
+    return 0;
+}
+
+static int tls_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms)
+{
+    tls_close(t);
+
+    esp_tls_cfg_t cfg = {
+        .cacert_buf = (const unsigned char *)mqtt_ca_pem_start,
+        .cacert_bytes = mqtt_ca_pem_end - mqtt_ca_pem_start,
+        .timeout_ms = timeout_ms,
+    };
+    bool resuming = false;
+#if MQTT_TLS_SESSION_RESUMPTION
+    cfg.client_session = s_session;
+    resuming = s_session != NULL;
+#endif
+
+    s_tls = esp_tls_init();
+    if (!s_tls)
+        return -1;
+
+    // Low-water mark of the heap while the handshake runs
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    heap_caps_monitor_local_minimum_free_size_start();
+    int64_t start = esp_timer_get_time();
+
+    int ret = esp_tls_conn_new_sync(host, strlen(host), port, &cfg, s_tls);
+
+    int64_t elapsed_ms = (esp_timer_get_time() - start) / 1000;
+    size_t heap_min = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+    heap_caps_monitor_local_minimum_free_size_stop();
+
+    if (ret != 1)
+    {
+        ESP_LOGE(TAG, "Handshake with %s:%d failed after %" PRId64 " ms", host, port, elapsed_ms);
+#if MQTT_TLS_SESSION_RESUMPTION
+        // A rejected session is not fatal, but do not offer it again
+        drop_session();
+#endif
+        tls_close(t);
+        return -1;
+    }
+
+    ESP_LOGI(TAG, "Handshake %s in %" PRId64 " ms, heap peak %u bytes (%u free at start)",
+             resuming ? "with session offered" : "full", elapsed_ms, (unsigned)(heap_before - heap_min),
+             (unsigned)heap_before);
+
+#if MQTT_TLS_SESSION_RESUMPTION
+    // Keep the (possibly renewed) session for the next reconnect
+    esp_tls_client_session_t *session = esp_tls_get_client_session(s_tls);
+    if (session)
+    {
+        drop_session();
+        s_session = session;
+    }
+#endif
+    return 0;
+}
+
+// ---------------- DATA ----------------
+
+static int tls_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
+{
+    int poll = tls_poll_read(t, timeout_ms);
+    if (poll <= 0)
+        return poll;
+
+    int ret = esp_tls_conn_read(s_tls, buffer, len);
+    if (ret == ESP_TLS_ERR_SSL_WANT_READ || ret == ESP_TLS_ERR_SSL_TIMEOUT)
+        return ERR_TCP_TRANSPORT_CONNECTION_TIMEOUT;
+    if (ret == 0)
+        return ERR_TCP_TRANSPORT_CONNECTION_CLOSED_BY_FIN;
+    return ret;
+}
+
+static int tls_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms)
+{
+    int poll = tls_poll_write(t, timeout_ms);
+    if (poll <= 0)
+        return poll;
+
+    int ret = esp_tls_conn_write(s_tls, buffer, len);
+    if (ret == ESP_TLS_ERR_SSL_WANT_WRITE)
+        return 0;
+    return ret;
+}
+
+static int tls_destroy(esp_transport_handle_t t)
+{
+    tls_close(t);
+#if MQTT_TLS_SESSION_RESUMPTION
+    drop_session();
+#endif
+    return 0;
+}
+
+// ---------------- PUBLIC FUNCTIONS ----------------
+
+esp_transport_handle_t mqtt_tls_transport_create(void)
+{
+    esp_transport_handle_t t = esp_transport_init();
+    if (!t)
+        return NULL;
+
+    esp_transport_set_func(t, tls_connect, tls_read, tls_write, tls_close, tls_poll_read, tls_poll_write, tls_destroy);
+    esp_transport_set_default_port(t, MQTT_TLS_DEFAULT_PORT);
+    return t;
+}
+
+#else
+
+esp_transport_handle_t mqtt_tls_transport_create(void)
+{
+    return NULL;
+}
+
+#endif
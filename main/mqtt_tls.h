@@ -0,0 +1,9 @@
+#pragma once
+#include "esp_transport.h"
+
+// TLS transport for the MQTT client, built on esp-tls so the session can be
+// kept across reconnects. Verifies the broker against the certificate embedded
+// from main/certs/mqtt_ca.pem (a CA or the broker's own self-signed cert).
+// Returns NULL when TLS is disabled in Kconfig; the client then picks its
+// transport from the broker URI as usual.
+esp_transport_handle_t mqtt_tls_transport_create(void);
@@ -0,0 +1,350 @@
+#include "ota_helper.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cmd_json.h"
+#include "config.h"
+#include "esp_delta_ota.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "mem_budget.h"
+
+static const char *TAG = "OTA";
+
+#define OTA_TASK_PRIORITY 5
+#define OTA_STALL_TIMEOUT_S 30 // no data for this long aborts the download
+
+// Header prepended by esp_delta_ota_patch_gen.py: magic + SHA-256 of the base image
+#define PATCH_HEADER_SIZE 64
+#define PATCH_DIGEST_SIZE 32
+#define PATCH_MAGIC 0xfccdde10
+
+static volatile bool s_running = false;
+static TaskHandle_t s_task = NULL;
+static bool s_pending_verify = false;
+static esp_timer_handle_t s_health_timer = NULL;
+
+// Current job (only one update at a time)
+static char s_url[256];
+static bool s_delta = false;
+static const esp_partition_t *s_base_partition = NULL;
+static esp_ota_handle_t s_ota_handle = 0;
+
+// Streaming buffer, the image itself is never held in RAM
+static uint8_t s_buf[OTA_RECV_BUFFER_SIZE];
+
+// ---------------- ROLLBACK ----------------
+
+// Fires when a new image did not become healthy in time
+static void health_timeout_cb(void *arg)
+{
+    ESP_LOGE(TAG, "Health check timed out - rolling back");
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+}
+
+void ota_helper_init(void)
+{
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+
+    ESP_LOGI(TAG, "Running from partition '%s' at 0x%" PRIx32, running->label, running->address);
+
+    if (esp_ota_get_state_partition(running, &state) != ESP_OK || state != ESP_OTA_IMG_PENDING_VERIFY)
+        return;
+
+    ESP_LOGW(TAG, "New image pending verification (timeout %d s)", OTA_HEALTH_TIMEOUT_S);
+    s_pending_verify = true;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = &health_timeout_cb,
+        .name = "ota_health"};
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &s_health_timer));
+    ESP_ERROR_CHECK(esp_timer_start_once(s_health_timer, (uint64_t)OTA_HEALTH_TIMEOUT_S * 1000000ULL));
+}
+
+void ota_helper_mark_healthy(void)
+{
+    if (!s_pending_verify)
+        return;
+
+    esp_timer_stop(s_health_timer);
+    esp_ota_mark_app_valid_cancel_rollback();
+    s_pending_verify = false;
+    ESP_LOGI(TAG, "Image marked valid, rollback cancelled");
+}
+
+// ---------------- DELTA PATCH CALLBACKS ----------------
+
+// Reads the base image (currently running slot) for the patcher
+static esp_err_t delta_read_cb(uint8_t *buf_p, size_t size, int src_offset)
+{
+    if (size <= 0)
+        return ESP_ERR_INVALID_ARG;
+    return esp_partition_read(s_base_partition, src_offset, buf_p, size);
+}
+
+// Writes the reconstructed image into the update slot
+static esp_err_t delta_write_cb(const uint8_t *buf_p, size_t size)
+{
+    if (size <= 0)
+        return ESP_ERR_INVALID_ARG;
+    return esp_ota_write(s_ota_handle, buf_p, size);
+}
+
+// ---------------- DOWNLOAD ----------------
+
+// Reads up to len bytes. A read timeout (-ESP_ERR_HTTP_EAGAIN) or an empty
+// read only means no data yet; the download fails once nothing arrived for
+// OTA_STALL_TIMEOUT_S. Returns the byte count, 0 once the body is complete,
+// or -1 on error.
+static int http_read(esp_http_client_handle_t client, uint8_t *buf, int len)
+{
+    int64_t start = esp_timer_get_time();
+    while (1)
+    {
+        int n = esp_http_client_read(client, (char *)buf, len);
+        if (n > 0)
+            return n;
+        if (n < 0 && n != -ESP_ERR_HTTP_EAGAIN)
+        {
+            ESP_LOGE(TAG, "Download error %d", n);
+            return -1;
+        }
+        if (n == 0)
+        {
+            if (esp_http_client_is_complete_data_received(client))
+                return 0;
+            // Same checks as the IDF native_ota example
+            if (errno == ECONNRESET || errno == ENOTCONN)
+            {
+                ESP_LOGE(TAG, "Connection closed (errno %d)", errno);
+                return -1;
+            }
+        }
+        if (esp_timer_get_time() - start > OTA_STALL_TIMEOUT_S * 1000000LL)
+        {
+            ESP_LOGE(TAG, "No data for %d s", OTA_STALL_TIMEOUT_S);
+            return -1;
+        }
+        // A timeout already waited timeout_ms, an empty read returns at once
+        if (n == 0)
+            vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+// Reads exactly len bytes from the HTTP stream
+static bool http_read_exact(esp_http_client_handle_t client, uint8_t *buf, int len)
+{
+    int total = 0;
+    while (total < len)
+    {
+        int n = http_read(client, buf + total, len - total);
+        if (n <= 0)
+            return false;
+        total += n;
+    }
+    return true;
+}
+
+static bool verify_patch_header(const uint8_t *header)
+{
+    uint32_t magic;
+    memcpy(&magic, header, sizeof(magic));
+    if (magic != PATCH_MAGIC)
+    {
+        ESP_LOGE(TAG, "Invalid patch magic 0x%08" PRIx32, magic);
+        return false;
+    }
+
+    // The patch only applies to the exact image it was generated against
+    uint8_t sha_256[PATCH_DIGEST_SIZE] = {0};
+    esp_partition_get_sha256(s_base_partition, sha_256);
+    if (memcmp(sha_256, header + sizeof(magic), PATCH_DIGEST_SIZE) != 0)
+    {
+        ESP_LOGE(TAG, "Patch was generated for a different base image");
+        return false;
+    }
+    return true;
+}
+
+// One update attempt; returns only when it failed (success restarts the device)
+static void run_update(void)
+{
+    esp_err_t err = ESP_FAIL;
+    esp_delta_ota_handle_t delta = NULL;
+    bool ota_begun = false;
+    int received = 0;
+
+    s_base_partition = esp_ota_get_running_partition();
+    const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
+
+    ESP_LOGI(TAG, "Starting %s update from %s -> '%s'", s_delta ? "delta" : "full", s_url, update_partition->label);
+
+    esp_http_client_config_t http_cfg = {
+        .url = s_url,
+        .timeout_ms = 10000,
+        .keep_alive_enable = true,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&http_cfg);
+    if (!client)
+    {
+        ESP_LOGE(TAG, "Could not create HTTP client");
+        return;
+    }
+
+    if (esp_http_client_open(client, 0) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not open %s", s_url);
+        goto cleanup;
+    }
+    esp_http_client_fetch_headers(client);
+    if (esp_http_client_get_status_code(client) != 200)
+    {
+        ESP_LOGE(TAG, "HTTP status %d", esp_http_client_get_status_code(client));
+        goto cleanup;
+    }
+
+    if (esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &s_ota_handle) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "esp_ota_begin failed");
+        goto cleanup;
+    }
+    ota_begun = true;
+
+    if (s_delta)
+    {
+        if (!http_read_exact(client, s_buf, PATCH_HEADER_SIZE) || !verify_patch_header(s_buf))
+            goto cleanup;
+
+        esp_delta_ota_cfg_t delta_cfg = {
+            .read_cb = &delta_read_cb,
+            .write_cb = &delta_write_cb,
+        };
+        delta = esp_delta_ota_init(&delta_cfg);
+        if (!delta)
+        {
+            ESP_LOGE(TAG, "esp_delta_ota_init failed");
+            goto cleanup;
+        }
+    }
+
+    // Stream the payload chunk by chunk into the update slot
+    while (1)
+    {
+        int n = http_read(client, s_buf, sizeof(s_buf));
+        if (n < 0)
+        {
+            ESP_LOGE(TAG, "Download failed after %d bytes", received);
+            err = ESP_FAIL;
+            goto cleanup;
+        }
+        if (n == 0)
+            break;
+
+        err = s_delta ? esp_delta_ota_feed_patch(delta, s_buf, n) : esp_ota_write(s_ota_handle, s_buf, n);
+        if (err != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Writing update failed: %s", esp_err_to_name(err));
+            goto cleanup;
+        }
+        received += n;
+    }
+
+    ESP_LOGI(TAG, "Received %d bytes", received);
+
+    if (s_delta && esp_delta_ota_finalize(delta) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Applying patch failed");
+        err = ESP_FAIL;
+        goto cleanup;
+    }
+
+    // esp_ota_end validates the written image
+    err = esp_ota_end(s_ota_handle);
+    ota_begun = false;
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Image validation failed: %s", esp_err_to_name(err));
+        goto cleanup;
+    }
+
+    err = esp_ota_set_boot_partition(update_partition);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not set boot partition: %s", esp_err_to_name(err));
+        goto cleanup;
+    }
+
+cleanup:
+    if (delta)
+        esp_delta_ota_deinit(delta);
+    if (ota_begun)
+        esp_ota_abort(s_ota_handle);
+    esp_http_client_close(client);
+    esp_http_client_cleanup(client);
+
+    if (err == ESP_OK)
+    {
+        ESP_LOGI(TAG, "Update complete, restarting...");
+        esp_restart();
+    }
+
+    ESP_LOGE(TAG, "Update aborted");
+}
+
+// Lives for the rest of the run once the first command arrived. A task that
+// deletes itself would leave its static TCB and stack in use until the idle
+// task cleans up, so a quick second command could not safely recreate it.
+static void ota_task(void *arg)
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        run_update();
+        s_running = false;
+    }
+}
+
+// ---------------- PUBLIC FUNCTIONS ----------------
+
+void ota_helper_handle_command(const char *data, int len)
+{
+    if (s_running)
+    {
+        ESP_LOGW(TAG, "Update already in progress");
+        return;
+    }
+
+    // Parsed in place: no heap use per command
+    if (!cmd_json_string(data, len, "url", s_url, sizeof(s_url)) || !s_url[0])
+    {
+        ESP_LOGE(TAG, "OTA command without valid url");
+        return;
+    }
+    s_delta = cmd_json_true(data, len, "delta");
+
+    if (!s_task)
+        s_task = APP_TASK_CREATE(ota_task, "ota_task", OTA_TASK_STACK_SIZE, OTA_TASK_PRIORITY);
+    if (!s_task)
+    {
+        ESP_LOGE(TAG, "Could not start OTA task");
+        return;
+    }
+
+    s_running = true;
+    xTaskNotifyGive(s_task);
+}
+
+bool ota_helper_is_running(void)
+{
+    return s_running;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdbool.h>
+
+// Checks whether the running image still awaits verification after an update
+// and arms the rollback deadline if so
+void ota_helper_init(void);
+
+// Marks the running image as valid (called once the device reached the broker)
+void ota_helper_mark_healthy(void);
+
+// Handles an OTA command received over MQTT, e.g.
+// {"url":"http://host:8000/patch.bin","delta":true}
+void ota_helper_handle_command(const char *data, int len);
+
+// Returns true while an update is being downloaded and written
+bool ota_helper_is_running(void);
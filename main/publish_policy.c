@@ -0,0 +1,13 @@
+#include "publish_policy.h"
+
+#include <math.h>
+
+bool publish_policy_due(const publish_policy_t *policy, const publish_record_t *last, float temp, float hum,
+                        int64_t now_us)
+{
+    bool diff_temp = fabsf(temp - last->temp) >= policy->threshold_temp;
+    bool diff_hum = fabsf(hum - last->hum) >= policy->threshold_hum;
+    bool heartbeat = (now_us - last->time_us) > policy->heartbeat_us;
+
+    return diff_temp || diff_hum || heartbeat;
+}
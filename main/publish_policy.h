@@ -0,0 +1,24 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Decides when a reading is published: on a meaningful change or when the
+// heartbeat interval has passed. Pure logic, also used by the host benchmarks.
+
+typedef struct
+{
+    float threshold_temp; // °C
+    float threshold_hum;  // %
+    int64_t heartbeat_us;
+} publish_policy_t;
+
+typedef struct
+{
+    float temp;
+    float hum;
+    int64_t time_us;
+} publish_record_t;
+
+// Returns true if (temp, hum) at now_us should be published given the last published record
+bool publish_policy_due(const publish_policy_t *policy, const publish_record_t *last, float temp, float hum,
+                        int64_t now_us);
@@ -4,11 +4,13 @@
 #include "dht.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
+#include "tlog.h"
 
 #define SENSOR_TYPE DHT_TYPE_AM2301 // AM2301 is compatible with DHT22
 #define SENSOR_GPIO CONFIG_SENSOR_GPIO
 
-static const char *TAG = "SENSOR";
+#define TLOG_TAG "SENSOR"
+static const char *TAG = TLOG_TAG;
 
 void sensor_init(void)
 {
@@ -22,12 +24,12 @@ bool sensor_read_values(float *temperature, float *humidity)
 
     if (res == ESP_OK)
     {
-        ESP_LOGD(TAG, "Read: %.1f degC, %.1f %%", *temperature, *humidity);
+        TLOGD(TLOG_TAG, "Read: %.1f degC, %.1f %%", *temperature, *humidity);
         return true;
     }
     else
     {
-        ESP_LOGE(TAG, "Could not read data from sensor: %d", res);
+        TLOGE(TLOG_TAG, "Could not read data from sensor: %d", res);
         return false;
     }
 }
@@ -0,0 +1,73 @@
+#include "tlog.h"
+
+#include "config.h"
+
+#if TLOG_ENABLE
+#include <stdatomic.h>
+#include <stdio.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/task.h"
+#include "mbedtls/base64.h"
+#include "mem_budget.h"
+
+static const char *TAG = "TLOG";
+
+#define TLOG_TASK_PRIORITY 1
+#define TLOG_TASK_STACK_SIZE 3072
+
+// Records are copied into a static ring; nothing is allocated per call
+static uint8_t s_ring_storage[TLOG_RING_SIZE];
+static StaticRingbuffer_t s_ring_struct;
+static RingbufHandle_t s_ring = NULL;
+static atomic_uint s_dropped = 0;
+
+void tlog_commit(const tlog_rec_t *rec)
+{
+    // Never wait for the drain: a full ring costs the record, not the caller's time
+    if (!s_ring || xRingbufferSend(s_ring, rec->buf, rec->len, 0) != pdTRUE)
+        atomic_fetch_add_explicit(&s_dropped, 1, memory_order_relaxed);
+}
+
+// Writes queued records to the console as "$TL:<base64>" lines
+static void tlog_task(void *arg)
+{
+    static char line[(TLOG_MAX_RECORD + 2) / 3 * 4 + 1];
+
+    while (1)
+    {
+        size_t len = 0;
+        uint8_t *item = xRingbufferReceive(s_ring, &len, portMAX_DELAY);
+        if (!item)
+            continue;
+
+        size_t olen = 0;
+        int ret = mbedtls_base64_encode((unsigned char *)line, sizeof(line), &olen, item, len);
+        vRingbufferReturnItem(s_ring, item);
+        if (ret == 0)
+            printf("$TL:%s\n", line);
+
+        unsigned dropped = atomic_exchange_explicit(&s_dropped, 0, memory_order_relaxed);
+        if (dropped)
+            ESP_LOGW(TAG, "%u records dropped", dropped);
+    }
+}
+
+void tlog_init(void)
+{
+    if (s_ring)
+        return;
+
+    s_ring = xRingbufferCreateStatic(sizeof(s_ring_storage), RINGBUF_TYPE_NOSPLIT, s_ring_storage, &s_ring_struct);
+    if (!APP_TASK_CREATE(tlog_task, "tlog", TLOG_TASK_STACK_SIZE, TLOG_TASK_PRIORITY))
+        ESP_LOGE(TAG, "Could not start drain task");
+}
+
+#else
+
+void tlog_init(void)
+{
+}
+
+#endif
@@ -0,0 +1,200 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+// Tokenised deferred logging.
+//
+// TLOGx(tag, fmt, ...) does not format anything on the device. The call site
+// stores a 32-bit hash of "tag: fmt" plus the raw arguments in a small binary
+// record, pushes it into a ring buffer and returns. A low-priority task drains
+// the ring to the console as "$TL:<base64>" lines, and tools/tlog_decode.py
+// expands them on the host with the format strings from the ELF.
+//
+// The format strings only exist in the non-allocated .tlog_fmt section of the
+// ELF, so they take no flash in the image. Consequences for call sites:
+//   - tag and fmt must be string literals (use a TLOG_TAG define per file)
+//   - fmt must not contain double quotes or backslash escapes
+//   - arguments: integers, float/double (sent as float), char * (first 32 bytes)
+//
+// Without CONFIG_TLOG_ENABLE the macros fall back to ESP_LOGx unchanged.
+
+#define TLOG_MAX_RECORD 64
+#define TLOG_MAX_STRING 32
+
+typedef struct
+{
+    uint8_t len;
+    uint8_t buf[TLOG_MAX_RECORD];
+} tlog_rec_t;
+
+// Starts the ring and the drain task. Records logged before are dropped.
+void tlog_init(void);
+
+// Queues a finished record (never blocks; drops when the ring is full)
+void tlog_commit(const tlog_rec_t *rec);
+
+// ---------------- TOKEN ----------------
+
+// 65599 hash over the first 64 bytes plus the length, evaluated at compile time.
+// tools/tlog_decode.py implements the same function. Constants are 65599^(i+1).
+#define TLOG_HC(s, i, k) ((i) < sizeof(s) - 1 ? (uint32_t)(uint8_t)(s)[(i) < sizeof(s) ? (i) : 0] * (k) : 0u)
+#define TLOG_HASH(s)                                                                        \
+    ((uint32_t)(sizeof(s) - 1) +                                                            \
+     TLOG_HC(s, 0, 0x0001003fu) + TLOG_HC(s, 1, 0x007e0f81u) + TLOG_HC(s, 2, 0x2e86d0bfu) + TLOG_HC(s, 3, 0x43ec5f01u) + \
+     TLOG_HC(s, 4, 0x162c613fu) + TLOG_HC(s, 5, 0xd62aee81u) + TLOG_HC(s, 6, 0xa311b1bfu) + TLOG_HC(s, 7, 0xd319be01u) + \
+     TLOG_HC(s, 8, 0xb156c23fu) + TLOG_HC(s, 9, 0x6698cd81u) + TLOG_HC(s, 10, 0x0d1b92bfu) + TLOG_HC(s, 11, 0xcc881d01u) + \
+     TLOG_HC(s, 12, 0x7280233fu) + TLOG_HC(s, 13, 0x50c7ac81u) + TLOG_HC(s, 14, 0x8da473bfu) + TLOG_HC(s, 15, 0x4f377c01u) + \
+     TLOG_HC(s, 16, 0xfaa8843fu) + TLOG_HC(s, 17, 0x33b78b81u) + TLOG_HC(s, 18, 0x45ac54bfu) + TLOG_HC(s, 19, 0x7a27db01u) + \
+     TLOG_HC(s, 20, 0xeacfe53fu) + TLOG_HC(s, 21, 0xae686a81u) + TLOG_HC(s, 22, 0x563335bfu) + TLOG_HC(s, 23, 0x6c593a01u) + \
+     TLOG_HC(s, 24, 0xe3f6463fu) + TLOG_HC(s, 25, 0x5fda4981u) + TLOG_HC(s, 26, 0xe03916bfu) + TLOG_HC(s, 27, 0x44cb9901u) + \
+     TLOG_HC(s, 28, 0x871ba73fu) + TLOG_HC(s, 29, 0xe70d2881u) + TLOG_HC(s, 30, 0x04bdf7bfu) + TLOG_HC(s, 31, 0x227ef801u) + \
+     TLOG_HC(s, 32, 0x7540083fu) + TLOG_HC(s, 33, 0xe3010781u) + TLOG_HC(s, 34, 0xe4c1d8bfu) + TLOG_HC(s, 35, 0x24735701u) + \
+     TLOG_HC(s, 36, 0x4f63693fu) + TLOG_HC(s, 37, 0xf2b5e681u) + TLOG_HC(s, 38, 0xa144b9bfu) + TLOG_HC(s, 39, 0x69a8b601u) + \
+     TLOG_HC(s, 40, 0xb685ca3fu) + TLOG_HC(s, 41, 0xb52bc581u) + TLOG_HC(s, 42, 0x5b469abfu) + TLOG_HC(s, 43, 0x111f1501u) + \
+     TLOG_HC(s, 44, 0x4ba72b3fu) + TLOG_HC(s, 45, 0xc962a481u) + TLOG_HC(s, 46, 0x33c77bbfu) + TLOG_HC(s, 47, 0x39d67401u) + \
+     TLOG_HC(s, 48, 0xafc78c3fu) + TLOG_HC(s, 49, 0xce5a8381u) + TLOG_HC(s, 50, 0x4bc75cbfu) + TLOG_HC(s, 51, 0x02ced301u) + \
+     TLOG_HC(s, 52, 0x83e6ed3fu) + TLOG_HC(s, 53, 0x63136281u) + TLOG_HC(s, 54, 0xc4463dbfu) + TLOG_HC(s, 55, 0x8b083201u) + \
+     TLOG_HC(s, 56, 0x69054e3fu) + TLOG_HC(s, 57, 0x268d4181u) + TLOG_HC(s, 58, 0xbe441ebfu) + TLOG_HC(s, 59, 0xf1829101u) + \
+     TLOG_HC(s, 60, 0x0022af3fu) + TLOG_HC(s, 61, 0xb7c82081u) + TLOG_HC(s, 62, 0x5ac0ffbfu) + TLOG_HC(s, 63, 0x553df001u))
+
+// ---------------- ENCODING ----------------
+// Record: level (1 byte), token (4 bytes LE), timestamp in ms (4 bytes LE), arguments.
+// Integers are zigzag varints (of the value as int64), floats 4 bytes LE, strings a length byte plus bytes.
+// A record that does not fit is cut short; the decoder marks missing arguments.
+
+static inline void tlog_put_bytes(tlog_rec_t *r, const void *data, size_t len)
+{
+    if (len > (size_t)(TLOG_MAX_RECORD - r->len))
+        len = TLOG_MAX_RECORD - r->len;
+    memcpy(r->buf + r->len, data, len);
+    r->len += len;
+}
+
+static inline void tlog_put_u32(tlog_rec_t *r, uint32_t v)
+{
+    uint8_t le[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    tlog_put_bytes(r, le, sizeof(le));
+}
+
+static inline void tlog_put_varint(tlog_rec_t *r, uint64_t v)
+{
+    while (v >= 0x80 && r->len < TLOG_MAX_RECORD)
+    {
+        r->buf[r->len++] = (uint8_t)v | 0x80;
+        v >>= 7;
+    }
+    if (r->len < TLOG_MAX_RECORD)
+        r->buf[r->len++] = (uint8_t)v;
+}
+
+static inline void tlog_put_i(tlog_rec_t *r, int64_t v)
+{
+    tlog_put_varint(r, ((uint64_t)v << 1) ^ (uint64_t)(v >> 63));
+}
+
+// Same wire format as signed; the decoder masks by the format's length modifier
+static inline void tlog_put_u(tlog_rec_t *r, uint64_t v)
+{
+    tlog_put_i(r, (int64_t)v);
+}
+
+static inline void tlog_put_f32(tlog_rec_t *r, float v)
+{
+    tlog_put_bytes(r, &v, sizeof(v));
+}
+
+static inline void tlog_put_f64(tlog_rec_t *r, double v)
+{
+    tlog_put_f32(r, (float)v);
+}
+
+static inline void tlog_put_str(tlog_rec_t *r, const char *s)
+{
+    size_t n = s ? strnlen(s, TLOG_MAX_STRING) : 0;
+    uint8_t len = (uint8_t)n;
+    tlog_put_bytes(r, &len, 1);
+    tlog_put_bytes(r, s, n);
+}
+
+static inline void tlog_begin(tlog_rec_t *r, uint8_t level, uint32_t token)
+{
+    r->len = 0;
+    r->buf[r->len++] = level;
+    tlog_put_u32(r, token);
+    tlog_put_u32(r, esp_log_timestamp());
+}
+
+// Picks the encoder from the argument's type (the call only sees the selected function)
+#define TLOG_PUT(r, x)                                       \
+    _Generic((x),                                            \
+        float: tlog_put_f32,                                 \
+        double: tlog_put_f64,                                \
+        char *: tlog_put_str,                                \
+        const char *: tlog_put_str,                          \
+        unsigned char: tlog_put_u,                           \
+        unsigned short: tlog_put_u,                          \
+        unsigned int: tlog_put_u,                            \
+        unsigned long: tlog_put_u,                           \
+        unsigned long long: tlog_put_u,                      \
+        default: tlog_put_i)(r, x)
+
+#define TLOG_NARGS(...) TLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define TLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+#define TLOG_CAT(a, b) TLOG_CAT_(a, b)
+#define TLOG_CAT_(a, b) a##b
+
+#define TLOG_PUT_0(r)
+#define TLOG_PUT_1(r, a) TLOG_PUT(r, a)
+#define TLOG_PUT_2(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_1(r, __VA_ARGS__)
+#define TLOG_PUT_3(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_2(r, __VA_ARGS__)
+#define TLOG_PUT_4(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_3(r, __VA_ARGS__)
+#define TLOG_PUT_5(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_4(r, __VA_ARGS__)
+#define TLOG_PUT_6(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_5(r, __VA_ARGS__)
+#define TLOG_PUT_7(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_6(r, __VA_ARGS__)
+#define TLOG_PUT_8(r, a, ...) TLOG_PUT(r, a), TLOG_PUT_7(r, __VA_ARGS__)
+#define TLOG_PUT_ARGS(r, ...) TLOG_CAT(TLOG_PUT_, TLOG_NARGS(__VA_ARGS__))(r, ##__VA_ARGS__)
+
+// Builds one record into rec (no level filtering). The format string goes into
+// the ELF's .tlog_fmt section only; the token is a compile-time constant.
+#define TLOG_RECORD(rec, level, tag, fmt, ...)                                        \
+    do                                                                                \
+    {                                                                                 \
+        static const uint32_t _tlog_token = TLOG_HASH(tag ": " fmt);                  \
+        __asm__ volatile(".pushsection .tlog_fmt,\"\",@progbits\n"                    \
+                         ".asciz \"" tag ": " fmt "\"\n"                              \
+                         ".popsection");                                              \
+        tlog_begin(rec, level, _tlog_token);                                          \
+        TLOG_PUT_ARGS(rec, ##__VA_ARGS__);                                            \
+    } while (0)
+
+// ---------------- LOG MACROS ----------------
+
+// Filters like ESP_LOGx: at compile time by LOG_LOCAL_LEVEL, at run time by
+// the level set with esp_log_level_set() for the tag
+#define TLOG_LEVEL(level, tag, fmt, ...)                                     \
+    do                                                                       \
+    {                                                                        \
+        if (LOG_LOCAL_LEVEL >= (level) && esp_log_level_get(tag) >= (level)) \
+        {                                                                    \
+            tlog_rec_t _tlog_rec;                                            \
+            TLOG_RECORD(&_tlog_rec, level, tag, fmt, ##__VA_ARGS__);         \
+            tlog_commit(&_tlog_rec);                                         \
+        }                                                                    \
+    } while (0)
+
+#if CONFIG_TLOG_ENABLE
+#define TLOGE(tag, fmt, ...) TLOG_LEVEL(ESP_LOG_ERROR, tag, fmt, ##__VA_ARGS__)
+#define TLOGW(tag, fmt, ...) TLOG_LEVEL(ESP_LOG_WARN, tag, fmt, ##__VA_ARGS__)
+#define TLOGI(tag, fmt, ...) TLOG_LEVEL(ESP_LOG_INFO, tag, fmt, ##__VA_ARGS__)
+#define TLOGD(tag, fmt, ...) TLOG_LEVEL(ESP_LOG_DEBUG, tag, fmt, ##__VA_ARGS__)
+#else
+#define TLOGE(tag, fmt, ...) ESP_LOGE(tag, fmt, ##__VA_ARGS__)
+#define TLOGW(tag, fmt, ...) ESP_LOGW(tag, fmt, ##__VA_ARGS__)
+#define TLOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#define TLOGD(tag, fmt, ...) ESP_LOGD(tag, fmt, ##__VA_ARGS__)
+#endif
@@ -2,6 +2,9 @@
 
 #include <string.h>
 
+#include "boot_trace.h"
+#include "device_state.h"
+
 #include "esp_event.h"
 #include "esp_log.h"
 #include "esp_wifi.h"
@@ -13,7 +16,6 @@
 #include "wifi_provisioning/scheme_softap.h"
 
 static const char *TAG = "WIFI_HELPER";
-static bool s_is_connected = false;
 
 // Event group for connection state
 const int WIFI_CONNECTED_EVENT = BIT0;
@@ -61,14 +63,15 @@ static void event_handler(void *arg, esp_event_base_t event_base,
     else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED)
     {
         ESP_LOGI(TAG, "Disconnected. Connecting again...");
-        s_is_connected = false;
+        device_state_set_wifi_connected(false);
         esp_wifi_connect();
     }
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP)
     {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
         ESP_LOGI(TAG, "Connected with IP: " IPSTR, IP2STR(&event->ip_info.ip));
-        s_is_connected = true;
+        device_state_set_wifi_connected(true);
+        boot_trace_mark(BOOT_STAGE_WIFI_CONNECTED);
         xEventGroupSetBits(wifi_event_group, WIFI_CONNECTED_EVENT);
     }
 }
@@ -82,6 +85,7 @@ void wifi_helper_init(void)
         ESP_ERROR_CHECK(nvs_flash_erase());
         ESP_ERROR_CHECK(nvs_flash_init());
     }
+    boot_trace_mark(BOOT_STAGE_NVS);
 
     // 2. Init netif & event loop
     ESP_ERROR_CHECK(esp_netif_init());
@@ -131,6 +135,7 @@ void wifi_helper_init(void)
         esp_wifi_set_mode(WIFI_MODE_STA);
         esp_wifi_start();
     }
+    boot_trace_mark(BOOT_STAGE_NETWORK);
 }
 
 void wifi_helper_reset_provisioning(void)
@@ -147,5 +152,7 @@ void wifi_helper_reset_provisioning(void)
 
 bool wifi_helper_is_connected(void)
 {
-    return s_is_connected;
+    device_state_t state;
+    device_state_get(&state);
+    return state.wifi_connected;
 }
@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""Generates main/comfort_lut.h, the fixed-point tables behind main/comfort.c.
+
+Usage:
+    python tools/gen_comfort_lut.py            # rewrite main/comfort_lut.h
+    python tools/gen_comfort_lut.py --check    # only print the error bounds
+
+The tables are evaluated with the reference formulas in double precision here,
+so the firmware never calls logf/expf (the ESP32-C3 has no FPU). --check runs a
+bit-exact Python model of comfort.c over the whole sensor range (-40..80 °C,
+0..100 % in 0.1 steps) and reports the maximum error against the reference.
+"""
+
+import argparse
+import math
+import os
+
+# Magnus coefficients (Sonntag 1990), valid -45..60 °C over water
+MAGNUS_B = 17.62
+MAGNUS_C = 243.12
+
+Q = 12  # fixed-point fraction bits of the dew point tables
+T_MIN, T_MAX = -40, 80  # °C, 1 °C steps
+RH_STEP10 = 5  # ln table step in 0.1 % (= 0.5 %)
+RH_LOW10 = 100  # below 10 % ln is too curved to interpolate, looked up per 0.1 %
+HI_T_MIN, HI_T_MAX = 20, 50  # heat index table, 1 °C steps
+HI_RH_STEP = 5  # %
+
+OUT = os.path.join(os.path.dirname(__file__), "..", "main", "comfort_lut.h")
+
+
+# ---------------- reference formulas ----------------
+
+def ref_dew_point(t, rh):
+    g = math.log(rh / 100.0) + MAGNUS_B * t / (MAGNUS_C + t)
+    return MAGNUS_C * g / (MAGNUS_B - g)
+
+
+def ref_svd(t):
+    """Saturation vapour density in g/m³ (Magnus over water)."""
+    es = 6.112 * math.exp(MAGNUS_B * t / (MAGNUS_C + t))  # hPa
+    return 216.7 * es / (273.15 + t)
+
+
+def ref_abs_humidity(t, rh):
+    return ref_svd(t) * rh / 100.0
+
+
+def ref_heat_index(t, rh):
+    """NOAA/NWS heat index (Rothfusz regression with adjustments), °C in/out."""
+    f = t * 9 / 5 + 32
+    hi = 0.5 * (f + 61.0 + (f - 68.0) * 1.2 + rh * 0.094)
+    if (hi + f) / 2 >= 80:
+        hi = (-42.379 + 2.04901523 * f + 10.14333127 * rh - 0.22475541 * f * rh
+              - 6.83783e-3 * f * f - 5.481717e-2 * rh * rh + 1.22874e-3 * f * f * rh
+              + 8.5282e-4 * f * rh * rh - 1.99e-6 * f * f * rh * rh)
+        if rh < 13 and 80 <= f <= 112:
+            hi -= ((13 - rh) / 4) * math.sqrt((17 - abs(f - 95)) / 17)
+        elif rh > 85 and 80 <= f <= 87:
+            hi += ((rh - 85) / 10) * ((87 - f) / 5)
+    return (hi - 32) * 5 / 9
+
+
+# ---------------- tables ----------------
+
+def tables():
+    ln_low = [round(math.log(max(h10, 1) / 1000.0) * (1 << Q)) for h10 in range(RH_LOW10)]
+    ln = [round(math.log(h10 / 1000.0) * (1 << Q)) for h10 in range(RH_LOW10, 1001, RH_STEP10)]
+    bt = [round(MAGNUS_B * t / (MAGNUS_C + t) * (1 << Q)) for t in range(T_MIN, T_MAX + 1)]
+    svd = [round(ref_svd(t) * 1000) for t in range(T_MIN, T_MAX + 1)]  # mg/m³
+    hi = [[round(ref_heat_index(t, rh) * 10) for t in range(HI_T_MIN, HI_T_MAX + 1)]
+          for rh in range(0, 101, HI_RH_STEP)]
+    return ln_low, ln, bt, svd, hi
+
+
+# ---------------- bit-exact model of comfort.c ----------------
+
+def cdiv(a, b):
+    """C integer division (truncates towards zero)."""
+    q = abs(a) // abs(b)
+    return q if (a >= 0) == (b >= 0) else -q
+
+
+def rdiv(a, b):
+    """Rounded division for b > 0, as RDIV() in comfort.c."""
+    return cdiv(a + b // 2 if a >= 0 else a - b // 2, b)
+
+
+def clamp(v, lo, hi):
+    return lo if v < lo else hi if v > hi else v
+
+
+def interp_t(table, t10):
+    t10 = clamp(t10, T_MIN * 10, T_MAX * 10)
+    off = t10 - T_MIN * 10
+    i, frac = off // 10, off % 10
+    if i == len(table) - 1:
+        return table[i]
+    return table[i] + cdiv((table[i + 1] - table[i]) * frac, 10)
+
+
+def model(ln_low, ln, bt, svd, hi, t10, h10):
+    # dew point
+    hc = clamp(h10, 1, 1000)
+    if hc < RH_LOW10:
+        lnv = ln_low[hc]
+    else:
+        i, frac = (hc - RH_LOW10) // RH_STEP10, (hc - RH_LOW10) % RH_STEP10
+        lnv = ln[i] if i == len(ln) - 1 else ln[i] + cdiv((ln[i + 1] - ln[i]) * frac, RH_STEP10)
+    g = lnv + interp_t(bt, t10)
+    dp = rdiv(rdiv(round(MAGNUS_C * 100) * g, round(MAGNUS_B * (1 << Q)) - g), 10)
+
+    # absolute humidity, 0.01 g/m³
+    ah = rdiv(interp_t(svd, t10) * clamp(h10, 0, 1000), 10000)
+
+    # heat index, None (COMFORT_HI_NONE) outside the table
+    if t10 < HI_T_MIN * 10 or t10 > HI_T_MAX * 10:
+        hix = None
+    else:
+        tc = t10 - HI_T_MIN * 10
+        rc = clamp(h10, 0, 1000)
+        ti, tf = tc // 10, tc % 10
+        ri, rf = rc // (HI_RH_STEP * 10), rc % (HI_RH_STEP * 10)
+        ti1 = min(ti + 1, HI_T_MAX - HI_T_MIN)
+        ri1 = min(ri + 1, 100 // HI_RH_STEP)
+        a = hi[ri][ti] * 10 + (hi[ri][ti1] - hi[ri][ti]) * tf
+        b = hi[ri1][ti] * 10 + (hi[ri1][ti1] - hi[ri1][ti]) * tf
+        hix = rdiv(a * (HI_RH_STEP * 10) + (b - a) * rf, HI_RH_STEP * 10 * 10)
+    return dp, ah, hix
+
+
+def check(tabs):
+    err_dp = err_ah = err_hi = 0.0
+    worst = {}
+    hi_errors = []
+    for t10 in range(T_MIN * 10, T_MAX * 10 + 1):
+        for h10 in range(10, 1001):
+            t, rh = t10 / 10, h10 / 10
+            dp, ah, hix = model(*tabs, t10, h10)
+            e = abs(dp / 10 - ref_dew_point(t, rh))
+            if e > err_dp:
+                err_dp, worst["dp"] = e, (t, rh)
+            e = abs(ah / 100 - ref_abs_humidity(t, rh))
+            if e > err_ah:
+                err_ah, worst["ah"] = e, (t, rh)
+            if HI_T_MIN * 10 <= t10 <= HI_T_MAX * 10:
+                e = abs(hix / 10 - ref_heat_index(t, rh))
+                hi_errors.append(e)
+                if e > err_hi:
+                    err_hi, worst["hi"] = e, (t, rh)
+    hi_errors.sort()
+    worst["hi_p99"] = hi_errors[int(len(hi_errors) * 0.99)]
+    return err_dp, err_ah, err_hi, worst
+
+
+def emit(tabs, errors):
+    ln_low, ln, bt, svd, hi = tabs
+    err_dp, err_ah, err_hi, worst = errors
+
+    def rows(values, per_line=12):
+        return "\n".join("    " + ", ".join(str(v) for v in values[i:i + per_line]) + ","
+                         for i in range(0, len(values), per_line))
+
+    hi_rows = "\n".join("    {" + ", ".join(str(v) for v in row) + "}," for row in hi)
+
+    return f"""#pragma once
+// Generated by tools/gen_comfort_lut.py - do not edit.
+//
+// Maximum error against the double-precision reference over -40..80 °C, 1..100 %:
+//   dew point          {err_dp:.3f} °C
+//   absolute humidity  {err_ah:.3f} g/m³
+//   heat index         {err_hi:.3f} °C (20..50 °C; 99 % of inputs within {worst["hi_p99"]:.3f} °C,
+//                      the maximum sits at the NOAA switch from the simple formula to Rothfusz)
+
+#include <stdint.h>
+
+#define COMFORT_Q {Q}
+#define COMFORT_MAGNUS_B_Q {round(MAGNUS_B * (1 << Q))}
+#define COMFORT_MAGNUS_C100 {round(MAGNUS_C * 100)}
+
+#define COMFORT_T_MIN {T_MIN}
+#define COMFORT_T_MAX {T_MAX}
+#define COMFORT_RH_STEP10 {RH_STEP10}
+#define COMFORT_RH_LOW10 {RH_LOW10}
+#define COMFORT_HI_T_MIN {HI_T_MIN}
+#define COMFORT_HI_T_MAX {HI_T_MAX}
+#define COMFORT_HI_RH_STEP {HI_RH_STEP}
+
+// ln(RH / 100) in Q{Q}, RH = 0..{RH_LOW10 / 10 - 0.1:.1f} % in 0.1 % steps (entry 0 clamps to 0.1 %)
+static const int16_t comfort_ln_rh_low[{len(ln_low)}] = {{
+{rows(ln_low)}
+}};
+
+// ln(RH / 100) in Q{Q}, RH = {RH_LOW10 / 10:.0f}..100 % in {RH_STEP10 / 10} % steps
+static const int16_t comfort_ln_rh[{len(ln)}] = {{
+{rows(ln)}
+}};
+
+// b * T / (c + T) in Q{Q}, T = {T_MIN}..{T_MAX} °C
+static const int32_t comfort_magnus_t[{len(bt)}] = {{
+{rows(bt)}
+}};
+
+// Saturation vapour density in mg/m³, T = {T_MIN}..{T_MAX} °C
+static const int32_t comfort_svd[{len(svd)}] = {{
+{rows(svd, 8)}
+}};
+
+// Heat index in 0.1 °C, rows RH = 0..100 % ({HI_RH_STEP} % steps), columns T = {HI_T_MIN}..{HI_T_MAX} °C
+static const int16_t comfort_hi_table[{len(hi)}][{len(hi[0])}] = {{
+{hi_rows}
+}};
+"""
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--check", action="store_true", help="only print the error bounds")
+    args = parser.parse_args()
+
+    tabs = tables()
+    errors = check(tabs)
+    err_dp, err_ah, err_hi, worst = errors
+    print(f"dew point         max error {err_dp:.3f} °C at {worst.get('dp')}")
+    print(f"absolute humidity max error {err_ah:.3f} g/m³ at {worst.get('ah')}")
+    print(f"heat index        max error {err_hi:.3f} °C at {worst.get('hi')}, p99 {worst['hi_p99']:.3f} °C")
+
+    if not args.check:
+        with open(OUT, "w") as f:
+            f.write(emit(tabs, errors))
+        print(f"wrote {os.path.normpath(OUT)}")
+
+
+if __name__ == "__main__":
+    main()
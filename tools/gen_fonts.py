@@ -0,0 +1,287 @@
+#!/usr/bin/env python3
+"""Generates the subset fonts and the value-line glyph atlas for main/gui.c.
+
+Usage (run by main/CMakeLists.txt when CONFIG_GUI_FONT_SUBSET is set):
+    python tools/gen_fonts.py --lvgl <lvgl component dir> --sdkconfig sdkconfig \\
+        --out build/esp-idf/main/gui_fonts.c main/*.c
+
+The UI sources are scanned for the strings that can reach the display:
+literals (or CONFIG_ string options) passed to gui_set_status() and
+lv_label_set_text(). Glyphs come from LVGL's own Montserrat sources, reduced to
+1 bpp and to the characters actually used. Kerning is dropped. The value font
+additionally gets a prerendered atlas in SSD1306 page layout (one byte = 8
+vertical pixels, LSB on top), so the value line is drawn by plain byte copies.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Characters gui_render_format_values() can produce ("%d.%d°C %d.%d%%")
+VALUE_CHARS = "0123456789.-°C% "
+
+STATUS_FONT = "lv_font_montserrat_10"
+VALUE_FONT = "lv_font_montserrat_14"
+
+# ---------------- SCANNING ----------------
+
+C_STRING = r'"((?:[^"\\]|\\.)*)"'
+STATUS_CALL = re.compile(r"(?:gui_set_status\(|lv_label_set_text\(\s*label_status\s*,)\s*(?:" + C_STRING + r"|(CONFIG_\w+))")
+VALUE_CALL = re.compile(r"(?:lv_label_set_text\(\s*label_temp\s*,|draw_value_line\()\s*" + C_STRING)
+
+
+def c_unescape(s):
+    return s.encode("utf-8").decode("unicode_escape").encode("latin-1").decode("utf-8")
+
+
+def read_sdkconfig(path):
+    values = {}
+    if path and os.path.exists(path):
+        for line in open(path, encoding="utf-8"):
+            m = re.match(r'(CONFIG_\w+)="(.*)"$', line.strip())
+            if m:
+                values[m.group(1)] = m.group(2)
+    return values
+
+
+def scan(sources, sdkconfig):
+    status, value = set(), set(VALUE_CHARS)
+    for path in sources:
+        text = open(path, encoding="utf-8").read()
+        for literal, option in STATUS_CALL.findall(text):
+            if option:
+                if option not in sdkconfig:
+                    print(f"warning: {option} shown on the display but not a string in sdkconfig", file=sys.stderr)
+                literal = sdkconfig.get(option, "")
+            else:
+                literal = c_unescape(literal)
+            status.update(literal)
+        for literal in VALUE_CALL.findall(text):
+            value.update(c_unescape(literal))
+    return status, value
+
+
+# ---------------- LVGL FONT SOURCES ----------------
+
+class Font:
+    def __init__(self, path):
+        src = open(path, encoding="utf-8").read()
+        src = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+
+        if re.search(r"\.bitmap_format\s*=\s*[12]", src):
+            sys.exit(f"{path}: compressed bitmaps are not supported")
+        self.bpp = int(re.search(r"\.bpp\s*=\s*(\d+)", src).group(1))
+        self.line_height = int(re.search(r"\.line_height\s*=\s*(\d+)", src).group(1))
+        self.base_line = int(re.search(r"\.base_line\s*=\s*(-?\d+)", src).group(1))
+
+        bitmap = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", src, re.S).group(1)
+        self.bitmap = bytes(int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", bitmap))
+
+        dsc = re.search(r"glyph_dsc\[\]\s*=\s*\{(.*?)\};", src, re.S).group(1)
+        self.glyphs = [
+            {k: int(v) for k, v in re.findall(r"\.(\w+)\s*=\s*(-?\d+)", entry)}
+            for entry in re.findall(r"\{([^{}]*)\}", dsc)
+        ]
+
+        lists = {
+            name: [int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+", body)]
+            for name, body in re.findall(r"(\w+)\[\]\s*=\s*\{([^}]*)\};", src)
+        }
+        cmaps = re.search(r"cmaps\[\]\s*=\s*\{(.*?)\};", src, re.S).group(1)
+        self.codepoints = {}
+        for entry in re.findall(r"\{([^{}]*)\}", cmaps):
+            f = dict(re.findall(r"\.(\w+)\s*=\s*([\w-]+)", entry))
+            start, length, gid = int(f["range_start"]), int(f["range_length"]), int(f["glyph_id_start"])
+            ulist = lists.get(f["unicode_list"])
+            ofs = lists.get(f["glyph_id_ofs_list"])
+            if ulist is None:
+                for i in range(length):
+                    self.codepoints[start + i] = gid + (ofs[i] if ofs else i)
+            else:
+                for i, delta in enumerate(ulist):
+                    self.codepoints[start + delta] = gid + (ofs[i] if ofs else i)
+
+    def glyph_pixels(self, gid):
+        """Box pixels of one glyph as rows of 0/1 (threshold at half intensity)."""
+        g = self.glyphs[gid]
+        w, h, bpp = g["box_w"], g["box_h"], self.bpp
+        rows = []
+        bit = g["bitmap_index"] * 8
+        for _ in range(h):
+            row = []
+            for _ in range(w):
+                byte = self.bitmap[bit // 8]
+                value = (byte >> (8 - bpp - bit % 8)) & ((1 << bpp) - 1)
+                row.append(1 if value >= (1 << (bpp - 1)) else 0)
+                bit += bpp
+            rows.append(row)
+        return rows
+
+    def data_size(self):
+        """Approximate flash footprint: bitmap + 8 bytes per glyph descriptor."""
+        return len(self.bitmap) + 8 * len(self.glyphs)
+
+
+# ---------------- OUTPUT ----------------
+
+def hex_rows(values, indent="    ", per_line=16):
+    values = list(values)
+    return "\n".join(indent + ", ".join(f"0x{v:02x}" for v in values[i:i + per_line]) + ","
+                     for i in range(0, len(values), per_line))
+
+
+def pack_1bpp(rows):
+    bits = [px for row in rows for px in row]
+    out = bytearray((len(bits) + 7) // 8)
+    for i, px in enumerate(bits):
+        if px:
+            out[i // 8] |= 0x80 >> (i % 8)
+    return out
+
+
+def subset_font(font, name, chars):
+    cps = sorted(cp for cp in map(ord, chars) if cp in font.codepoints)
+    missing = sorted(set(chars) - {chr(cp) for cp in cps})
+    if missing:
+        print(f"warning: {name}: no glyph for {''.join(missing)!r}", file=sys.stderr)
+
+    bitmap = bytearray()
+    dsc = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,"]
+    for cp in cps:
+        g = font.glyphs[font.codepoints[cp]]
+        dsc.append(f"    {{.bitmap_index = {len(bitmap)}, .adv_w = {g['adv_w']}, .box_w = {g['box_w']}, "
+                   f".box_h = {g['box_h']}, .ofs_x = {g['ofs_x']}, .ofs_y = {g['ofs_y']}}} /* U+{cp:04X} */,")
+        bitmap += pack_1bpp(font.glyph_pixels(font.codepoints[cp]))
+
+    first = cps[0]
+    code = f"""
+// ---------------- {name} ({len(cps)} glyphs) ----------------
+
+static LV_ATTRIBUTE_LARGE_CONST const uint8_t {name}_bitmap[] = {{
+{hex_rows(bitmap)}
+}};
+
+static const lv_font_fmt_txt_glyph_dsc_t {name}_glyph_dsc[] = {{
+{chr(10).join(dsc)}
+}};
+
+static const uint16_t {name}_unicode_list[] = {{
+    {", ".join(f"0x{cp - first:x}" for cp in cps)},
+}};
+
+static const lv_font_fmt_txt_cmap_t {name}_cmaps[] = {{
+    {{.range_start = {first}, .range_length = {cps[-1] - first + 1}, .glyph_id_start = 1,
+     .unicode_list = {name}_unicode_list, .glyph_id_ofs_list = NULL, .list_length = {len(cps)},
+     .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY}},
+}};
+
+static const lv_font_fmt_txt_dsc_t {name}_dsc = {{
+    .glyph_bitmap = {name}_bitmap,
+    .glyph_dsc = {name}_glyph_dsc,
+    .cmaps = {name}_cmaps,
+    .kern_dsc = NULL,
+    .kern_scale = 0,
+    .cmap_num = 1,
+    .bpp = 1,
+    .kern_classes = 0,
+    .bitmap_format = 0,
+}};
+
+const lv_font_t {name} = {{
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,
+    .line_height = {font.line_height},
+    .base_line = {font.base_line},
+    .subpx = LV_FONT_SUBPX_NONE,
+    .underline_position = -1,
+    .underline_thickness = 1,
+    .dsc = &{name}_dsc,
+}};
+"""
+    size = len(bitmap) + 8 * (len(cps) + 1) + 2 * len(cps)
+    return code, size
+
+
+def atlas(font, chars):
+    """Glyphs in SSD1306 page layout, page-major per glyph: [page][column]."""
+    pages = (font.line_height + 7) // 8
+    cps = sorted(cp for cp in map(ord, chars) if cp in font.codepoints)
+    bitmap = bytearray()
+    entries = []
+    for cp in cps:
+        g = font.glyphs[font.codepoints[cp]]
+        advance = (g["adv_w"] + 8) // 16  # adv_w is stored in 1/16 px
+        width = max(advance, g["ofs_x"] + g["box_w"], 1)
+        top = font.line_height - font.base_line - g["ofs_y"] - g["box_h"]
+
+        columns = [[0] * pages for _ in range(width)]
+        for y, row in enumerate(font.glyph_pixels(font.codepoints[cp])):
+            for x, px in enumerate(row):
+                cx, cy = g["ofs_x"] + x, top + y
+                if px and 0 <= cx < width and 0 <= cy < pages * 8:
+                    columns[cx][cy // 8] |= 1 << (cy % 8)
+
+        entries.append(f"    {{.codepoint = 0x{cp:04x}, .offset = {len(bitmap)}, .width = {width}, .advance = {advance}}},")
+        for p in range(pages):
+            bitmap += bytes(col[p] for col in columns)
+
+    code = f"""
+// ---------------- value line atlas (SSD1306 pages) ----------------
+
+static const uint8_t gui_atlas_bitmap[] = {{
+{hex_rows(bitmap)}
+}};
+
+static const gui_atlas_glyph_t gui_atlas_glyphs[] = {{
+{chr(10).join(entries)}
+}};
+
+const gui_atlas_t gui_atlas = {{
+    .glyphs = gui_atlas_glyphs,
+    .count = {len(cps)},
+    .pages = {pages},
+    .bitmap = gui_atlas_bitmap,
+}};
+"""
+    return code, len(bitmap) + 6 * len(cps)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--lvgl", required=True, help="LVGL component directory")
+    parser.add_argument("--sdkconfig", help="sdkconfig with CONFIG_ strings shown on the display")
+    parser.add_argument("--out", required=True)
+    parser.add_argument("sources", nargs="+", help="UI sources to scan")
+    args = parser.parse_args()
+
+    status_chars, value_chars = scan(args.sources, read_sdkconfig(args.sdkconfig))
+    font_dir = os.path.join(args.lvgl, "src", "font")
+    status_font = Font(os.path.join(font_dir, STATUS_FONT + ".c"))
+    value_font = Font(os.path.join(font_dir, VALUE_FONT + ".c"))
+
+    status_code, status_size = subset_font(status_font, "gui_font_status", status_chars)
+    value_code, value_size = subset_font(value_font, "gui_font_value", value_chars)
+    atlas_code, atlas_size = atlas(value_font, value_chars)
+
+    out = f"""// Generated by tools/gen_fonts.py from {STATUS_FONT} and {VALUE_FONT} - do not edit.
+// status: {''.join(sorted(status_chars))!r}
+// value:  {''.join(sorted(value_chars))!r}
+
+#include "gui_fonts.h"
+{status_code}{value_code}{atlas_code}"""
+
+    # Unchanged output keeps its timestamp, so main/ edits do not rebuild it
+    if not os.path.exists(args.out) or open(args.out, encoding="utf-8").read() != out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            f.write(out)
+
+    before = status_font.data_size() + value_font.data_size()
+    after = status_size + value_size + atlas_size
+    # Estimated from bitmap and descriptor sizes, not measured in the linked image
+    print(f"gui fonts (estimate): {STATUS_FONT} + {VALUE_FONT} ~{before} B -> subset fonts + atlas ~{after} B "
+          f"({len(status_chars)} + {len(value_chars)} glyphs)")
+
+
+if __name__ == "__main__":
+    main()
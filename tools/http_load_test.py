@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""Burst load test for the local status endpoint (main/http_status.c).
+
+Usage:
+    python tools/http_load_test.py <device-ip> [--port 80] [-n 2000] [-c 4] [--path /metrics]
+
+Sends n GET requests from c concurrent clients, one connection per request
+like a Prometheus scraper. Every response must be 200 and parse: /metrics as
+Prometheus text (a TYPE line before each sample), /state as JSON. Prints the
+throughput and latency percentiles and exits with status 1 on any failed or
+malformed response.
+
+The firmware does not build for the ESP-IDF linux target (display and sensor
+drivers), so the test runs against a device.
+"""
+
+import argparse
+import http.client
+import json
+import sys
+import threading
+import time
+
+
+def check_metrics(body):
+    typed = set()
+    for line in body.splitlines():
+        if line.startswith("# TYPE "):
+            typed.add(line.split()[2])
+        elif line and not line.startswith("#"):
+            name, value = line.split(" ", 1)
+            float(value)
+            if name not in typed:
+                raise ValueError(f"sample without TYPE: {name}")
+    if not typed:
+        raise ValueError("no metrics")
+
+
+def check_state(body):
+    state = json.loads(body)
+    if "version" not in state:
+        raise ValueError("no version")
+
+
+def worker(args, count, latencies, errors, lock):
+    check = check_state if args.path == "/state" else check_metrics
+    for _ in range(count):
+        start = time.perf_counter()
+        try:
+            conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+            conn.request("GET", args.path)
+            resp = conn.getresponse()
+            body = resp.read().decode()
+            conn.close()
+            if resp.status != 200:
+                raise ValueError(f"HTTP {resp.status}")
+            check(body)
+        except (OSError, ValueError, http.client.HTTPException) as e:
+            with lock:
+                errors.append(str(e))
+            continue
+        with lock:
+            latencies.append(time.perf_counter() - start)
+
+
+def percentile(sorted_values, p):
+    return sorted_values[int(p * (len(sorted_values) - 1) + 0.5)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", default="/metrics", choices=("/metrics", "/state"))
+    parser.add_argument("-n", "--requests", type=int, default=2000)
+    parser.add_argument("-c", "--concurrency", type=int, default=4)
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds per request")
+    args = parser.parse_args()
+
+    latencies, errors = [], []
+    lock = threading.Lock()
+    per_client = [args.requests // args.concurrency + (i < args.requests % args.concurrency)
+                  for i in range(args.concurrency)]
+    threads = [threading.Thread(target=worker, args=(args, n, latencies, errors, lock)) for n in per_client]
+
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+
+    print(f"{args.path}: {len(latencies)} ok, {len(errors)} failed in {elapsed:.2f} s "
+          f"({len(latencies) / elapsed:.0f} req/s, {args.concurrency} clients)")
+    if latencies:
+        latencies.sort()
+        print("latency ms: " + ", ".join(f"{name} {percentile(latencies, p) * 1000:.1f}" for name, p in
+                                         (("p50", 0.50), ("p90", 0.90), ("p99", 0.99), ("max", 1.0))))
+    for error in sorted(set(errors)):
+        print(f"  {errors.count(error)} x {error}", file=sys.stderr)
+    return 1 if errors or not latencies else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""RAM budget per subsystem, read from the linker map file.
+
+Usage:
+    cmake --build build --target mem_budget
+    python tools/mem_budget.py build/TemperaturSensor.map [--json]
+
+Static data (.data/.bss, including task stacks in CONFIG_STATIC_MEMORY mode),
+IRAM code and flash .rodata (constants, format strings) are attributed to the
+application module or ESP-IDF component that defined them. Heap usage at runtime is not part of this report; it is
+logged at debug level by mem_budget_log() on the device.
+"""
+
+import argparse
+import json
+import re
+import sys
+from collections import defaultdict
+
+# Archives grouped into one subsystem line
+GROUPS = {
+    "wifi": ("net80211", "pp", "core", "phy", "espnow", "mesh", "smartconfig", "wpa_supplicant",
+             "esp_wifi", "wifi_provisioning", "esp_phy", "esp_coex", "coexist", "protocomm"),
+    "lwip": ("lwip", "esp_netif"),
+    "mqtt": ("mqtt", "tcp_transport", "esp-tls", "esp_http_client"),
+    "mbedtls": ("mbedtls", "mbedcrypto", "mbedx509", "everest", "p256m"),
+    "lvgl": ("lvgl__lvgl", "lvgl"),
+    "display": ("esp_lcd", "esp_lcd_sh1107", "espressif__esp_lcd_sh1107", "driver", "esp_driver_i2c"),
+    "freertos": ("freertos",),
+    "ota": ("app_update", "espressif__esp_delta_ota", "esp_delta_ota", "bootloader_support"),
+}
+
+RAM_SECTIONS = ("dram", "data", "bss", "noinit", "rtc")
+BSS_INPUTS = ("bss", "sbss", "COMMON", "noinit")
+
+INPUT_FULL = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+INPUT_NAME = re.compile(r"^ (\S+)$")
+INPUT_CONT = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+OUTPUT_SEC = re.compile(r"^(\.\S+)")
+OBJECT = re.compile(r"lib([^/()]+)\.a\(([^)]+?)(?:\.c|\.cpp|\.S)?\.o(?:bj)?\)$")
+
+
+def subsystem(origin):
+    m = OBJECT.search(origin)
+    if not m:
+        return "other"
+    lib, obj = m.groups()
+    if lib == "main":
+        return "app/" + obj
+    for group, libs in GROUPS.items():
+        if lib in libs:
+            return group
+    return "other"
+
+
+def parse(path):
+    usage = defaultdict(lambda: {"data": 0, "bss": 0, "iram": 0, "rodata": 0})
+    in_map = False
+    out_sec = ""
+    pending = None
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_map:
+                in_map = line.startswith("Linker script and memory map")
+                continue
+
+            m = OUTPUT_SEC.match(line)
+            if m:
+                out_sec = m.group(1)
+                pending = None
+                continue
+
+            m = INPUT_FULL.match(line)
+            if m:
+                name, size, origin = m.group(1), int(m.group(3), 16), m.group(4)
+            elif pending and INPUT_CONT.match(line):
+                m = INPUT_CONT.match(line)
+                name, size, origin = pending, int(m.group(2), 16), m.group(3)
+            else:
+                m = INPUT_NAME.match(line)
+                pending = m.group(1) if m and not m.group(1).startswith("*") else None
+                continue
+            pending = None
+
+            if size == 0 or name.startswith("*"):
+                continue
+
+            if "iram" in out_sec:
+                kind = "iram"
+            elif "rodata" in out_sec:
+                kind = "rodata"
+            elif any(k in out_sec for k in RAM_SECTIONS) and "flash" not in out_sec:
+                kind = "bss" if any(name.lstrip(".").startswith(b) for b in BSS_INPUTS) else "data"
+            else:
+                continue
+            usage[subsystem(origin)][kind] += size
+
+    return usage
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("map_file")
+    parser.add_argument("--json", action="store_true", help="machine-readable output")
+    args = parser.parse_args()
+
+    usage = parse(args.map_file)
+    rows = sorted(usage.items(), key=lambda kv: -(kv[1]["data"] + kv[1]["bss"]))
+
+    if args.json:
+        json.dump({name: dict(u, dram=u["data"] + u["bss"]) for name, u in rows}, sys.stdout, indent=2)
+        print()
+        return
+
+    total = {"data": 0, "bss": 0, "iram": 0, "rodata": 0}
+    print(f"{'Subsystem':<24}{'.data':>8}{'.bss':>8}{'DRAM':>8}{'IRAM':>8}{'.rodata':>9}")
+    print("-" * 65)
+    for name, u in rows:
+        print(f"{name:<24}{u['data']:>8}{u['bss']:>8}{u['data'] + u['bss']:>8}{u['iram']:>8}{u['rodata']:>9}")
+        for k in total:
+            total[k] += u[k]
+    print("-" * 65)
+    print(f"{'Total':<24}{total['data']:>8}{total['bss']:>8}{total['data'] + total['bss']:>8}{total['iram']:>8}"
+          f"{total['rodata']:>9}")
+
+
+if __name__ == "__main__":
+    main()
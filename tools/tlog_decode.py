@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Expands tokenised log records ("$TL:<base64>" lines, see main/tlog.h).
+
+Usage:
+    python tools/tlog_decode.py build/TemperaturSensor.elf --port /dev/ttyUSB0
+    python tools/tlog_decode.py build/TemperaturSensor.elf < captured.log
+    python tools/tlog_decode.py build/TemperaturSensor.elf --list
+
+The format strings are read from the .tlog_fmt section of the ELF that was
+flashed; a different build may map tokens to the wrong (or no) string. Lines
+that are not records (boot messages, ESP_LOG output) are passed through.
+"""
+
+import argparse
+import base64
+import re
+import struct
+import sys
+
+HASH_LEN = 64  # must match TLOG_HASH in main/tlog.h
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D", 5: "V"}
+
+RECORD = re.compile(r"\$TL:([A-Za-z0-9+/=]+)")
+SPEC = re.compile(r"%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGcsp%])")
+
+
+# ---------------- ELF ----------------
+
+def read_section(path, wanted):
+    """Returns the contents of one section of a little-endian ELF32/ELF64 file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF" or data[5] != 1:
+        sys.exit(f"{path}: not a little-endian ELF file")
+
+    is64 = data[4] == 2
+    if is64:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        sh = lambda i: struct.unpack_from("<IIQQQQ", data, shoff + i * shentsize)
+    else:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        sh = lambda i: struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+
+    # name, type, flags, addr, offset, size
+    strtab = sh(shstrndx)
+    names = data[strtab[4]:strtab[4] + strtab[5]]
+    for i in range(shnum):
+        name_off, _, _, _, offset, size = sh(i)
+        name = names[name_off:names.index(b"\0", name_off)].decode()
+        if name == wanted:
+            return data[offset:offset + size]
+    sys.exit(f"{path}: no {wanted} section (built without CONFIG_TLOG_ENABLE?)")
+
+
+def token(s):
+    """65599 hash over the first HASH_LEN bytes plus the length (TLOG_HASH)."""
+    h = len(s)
+    coef = 65599
+    for c in s[:HASH_LEN]:
+        h = (h + coef * c) & 0xFFFFFFFF
+        coef = (coef * 65599) & 0xFFFFFFFF
+    return h
+
+
+def load_formats(elf):
+    table = {}
+    for raw in read_section(elf, ".tlog_fmt").split(b"\0"):
+        if not raw:
+            continue
+        tok = token(raw)
+        text = raw.decode("utf-8", errors="replace")
+        if tok in table and table[tok] != text:
+            print(f"warning: token {tok:08x} collides: {table[tok]!r} / {text!r}", file=sys.stderr)
+        table[tok] = text
+    return table
+
+
+# ---------------- RECORDS ----------------
+
+def read_varint(buf, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(buf):
+            raise IndexError
+        b = buf[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, pos
+
+
+def expand(fmt, args, pos):
+    """printf-style expansion, consuming encoded arguments as the specifiers demand."""
+    out = []
+    last = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        spec = "%" + flags + (width or "") + (f".{prec}" if prec else "")
+        try:
+            if conv in "eEfFgG":
+                value, = struct.unpack_from("<f", args, pos)
+                pos += 4
+                out.append((spec + conv) % value)
+            elif conv == "s":
+                n = args[pos]
+                value = args[pos + 1:pos + 1 + n].decode("utf-8", errors="replace")
+                pos += 1 + n
+                out.append((spec + "s") % value)
+            else:
+                raw, pos = read_varint(args, pos)
+                value = (raw >> 1) ^ -(raw & 1)  # zigzag
+                if conv in "ouxXcp":
+                    value &= 0xFFFFFFFFFFFFFFFF if length in ("ll", "j") else 0xFFFFFFFF
+                if conv == "c":
+                    out.append((spec + "c") % chr(value))
+                elif conv == "p":
+                    out.append(f"0x{value:x}")
+                else:
+                    out.append((spec + ("d" if conv in "iu" else conv)) % value)
+        except (IndexError, struct.error):
+            out.append("<?>")
+    out.append(fmt[last:])
+    return "".join(out)
+
+
+def decode(formats, b64):
+    rec = base64.b64decode(b64)
+    if len(rec) < 9:
+        return f"<short tlog record {rec.hex()}>"
+    level = LEVELS.get(rec[0], "?")
+    tok, ts = struct.unpack_from("<II", rec, 1)
+    fmt = formats.get(tok)
+    if fmt is None:
+        return f"{level} ({ts}) <unknown token {tok:08x}: {rec[9:].hex()}>"
+    return f"{level} ({ts}) {expand(fmt, rec, 9)}"
+
+
+def lines(args):
+    if args.port:
+        import serial  # pyserial ships with ESP-IDF
+
+        with serial.Serial(args.port, args.baud) as port:
+            while True:
+                yield port.readline().decode("utf-8", errors="replace")
+    else:
+        yield from sys.stdin
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf")
+    parser.add_argument("--port", help="read from a serial port instead of stdin")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--list", action="store_true", help="print the token table and exit")
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf)
+    if args.list:
+        for tok, fmt in sorted(formats.items(), key=lambda kv: kv[1]):
+            print(f"{tok:08x}  {fmt}")
+        return
+
+    try:
+        for line in lines(args):
+            m = RECORD.search(line)
+            if m:
+                line = line[:m.start()] + decode(formats, m.group(1)) + line[m.end():]
+            sys.stdout.write(line if line.endswith("\n") else line + "\n")
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()